@@ -0,0 +1,186 @@
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include "Arduino.h"
+#include "scheduler.h"
+
+HostSerial Serial;
+
+void HostSerial::begin( unsigned long ulBaud )
+{
+  ( void ) ulBaud;
+
+  if( NULL == pxOut )
+  {
+    const char *pcPath = getenv( "SCHED_SERIAL_LOG" );
+    pxOut = ( NULL != pcPath ) ? fopen( pcPath, "w" ) : NULL;
+    if( NULL == pxOut )
+    {
+      pxOut = stdout;
+    }
+  }
+}
+
+/* The Arduino code opens and closes the port around every message. The
+ * stream is kept open here and only flushed, so that no output is lost. */
+void HostSerial::end( void )
+{
+  flush();
+}
+
+void HostSerial::flush( void )
+{
+  if( NULL != pxOut )
+  {
+    fflush( pxOut );
+  }
+}
+
+void HostSerial::prvWrite( const char *pcStr )
+{
+  if( NULL == pxOut )
+  {
+    begin( 0 );
+  }
+
+  if( xAtLineStart )
+  {
+    fprintf( pxOut, "[%10" PRIu32 "] ", ( uint32_t ) xTaskGetTickCount() );
+    xAtLineStart = false;
+  }
+  fputs( pcStr, pxOut );
+}
+
+void HostSerial::print( const char *pcStr )
+{
+  prvWrite( pcStr );
+}
+
+void HostSerial::print( char cChar )
+{
+  char pcBuffer[ 2 ] = { cChar, '\0' };
+  prvWrite( pcBuffer );
+}
+
+void HostSerial::print( long lValue, int iBase )
+{
+  char pcBuffer[ 24 ];
+  snprintf( pcBuffer, sizeof( pcBuffer ), ( HEX == iBase ) ? "%lx" : "%ld", lValue );
+  prvWrite( pcBuffer );
+}
+
+void HostSerial::print( unsigned long ulValue, int iBase )
+{
+  char pcBuffer[ 24 ];
+  snprintf( pcBuffer, sizeof( pcBuffer ), ( HEX == iBase ) ? "%lx" : "%lu", ulValue );
+  prvWrite( pcBuffer );
+}
+
+void HostSerial::print( double dValue, int iDigits )
+{
+  char pcBuffer[ 32 ];
+  snprintf( pcBuffer, sizeof( pcBuffer ), "%.*f", iDigits, dValue );
+  prvWrite( pcBuffer );
+}
+
+void HostSerial::println( void )
+{
+  prvWrite( "\n" );
+  xAtLineStart = true;
+}
+
+unsigned long millis( void )
+{
+  return ( unsigned long ) xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+unsigned long micros( void )
+{
+  return millis() * 1000UL;
+}
+
+/* Wall clock time in microseconds, for schedUSE_SUBTICK_ACCOUNTING. Unlike
+ * micros(), it differs between runs. */
+extern "C" unsigned long ulHostMonotonicMicros( void )
+{
+  struct timespec xNow;
+
+  clock_gettime( CLOCK_MONOTONIC, &xNow );
+  return ( unsigned long ) xNow.tv_sec * 1000000UL + ( unsigned long ) ( xNow.tv_nsec / 1000 );
+}
+
+/* Same clock in nanoseconds, for schedUSE_OVERHEAD_STATS. */
+extern "C" unsigned long ulHostMonotonicNanos( void )
+{
+  struct timespec xNow;
+
+  clock_gettime( CLOCK_MONOTONIC, &xNow );
+  return ( unsigned long ) xNow.tv_sec * 1000000000UL + ( unsigned long ) xNow.tv_nsec;
+}
+
+#if( schedUSE_TRACE == 1 )
+  /* Appends the pending trace records to the file named by the
+   * SCHED_TRACE_FILE environment variable, if it is set. */
+  static void prvHostTraceWrite( void )
+  {
+    static FILE *pxTraceFile = NULL;
+    static bool xTraceOpened = false;
+    SchedTraceRecord_t pxRecords[ 16 ];
+    UBaseType_t uxCount;
+
+    if( !xTraceOpened )
+    {
+      const char *pcPath = getenv( "SCHED_TRACE_FILE" );
+      pxTraceFile = ( NULL != pcPath ) ? fopen( pcPath, "wb" ) : NULL;
+      xTraceOpened = true;
+    }
+    if( NULL == pxTraceFile )
+    {
+      return;
+    }
+
+    while( 0 != ( uxCount = uxSchedulerTraceRead( pxRecords, 16 ) ) )
+    {
+      /* The host is little endian, so the records are written as they are. */
+      fwrite( pxRecords, sizeof( SchedTraceRecord_t ), uxCount, pxTraceFile );
+    }
+    fflush( pxTraceFile );
+  }
+#endif /* schedUSE_TRACE */
+
+/* Same as the Arduino FreeRTOS port, which runs the sketch loop() as the idle hook. */
+extern "C" void vApplicationIdleHook( void )
+{
+  loop();
+  #if( schedUSE_TRACE == 1 )
+    prvHostTraceWrite();
+  #endif /* schedUSE_TRACE */
+}
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+  /* The kernel takes the idle task buffers from the application when it
+   * supports static allocation. The Arduino FreeRTOS library has its own. */
+  extern "C" void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize )
+  {
+    static StaticTask_t xIdleTaskBuffer;
+    static StackType_t xIdleTaskStack[ schedSTATIC_STACK_DEPTH ];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskBuffer;
+    *ppxIdleTaskStackBuffer = xIdleTaskStack;
+    *pulIdleTaskStackSize = schedSTATIC_STACK_DEPTH;
+  }
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+extern "C" void vHostAssertCalled( const char *pcFile, unsigned long ulLine )
+{
+  Serial.print( "ASSERT " );
+  Serial.print( pcFile );
+  Serial.print( ':' );
+  Serial.println( ulLine );
+  Serial.flush();
+  abort();
+}
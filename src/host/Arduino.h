@@ -0,0 +1,55 @@
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Minimal Arduino core replacement for the host build. Only what the
+ * scheduler and the pollingServer.ino demo use is provided. */
+
+#define DEC 10
+#define HEX 16
+
+/* Replacement for the Arduino HardwareSerial object. Output goes to stdout,
+ * or to the file named by the SCHED_SERIAL_LOG environment variable. Every
+ * line is prefixed with the tick count at which it was started. The POSIX
+ * port drives the tick with a host timer, so two runs do not print the same
+ * log; repeatable runs need the simulator of tools/schedSimulator.cpp. */
+class HostSerial
+{
+public:
+  void begin( unsigned long ulBaud );
+  void end( void );
+  void flush( void );
+
+  void print( const char *pcStr );
+  void print( char cChar );
+  void print( long lValue, int iBase = DEC );
+  void print( unsigned long ulValue, int iBase = DEC );
+  void print( int iValue, int iBase = DEC ) { print( ( long ) iValue, iBase ); }
+  void print( unsigned int uiValue, int iBase = DEC ) { print( ( unsigned long ) uiValue, iBase ); }
+  void print( double dValue, int iDigits = 2 );
+
+  void println( void );
+  template< typename T > void println( T xValue ) { print( xValue ); println(); }
+  template< typename T > void println( T xValue, int iFormat ) { print( xValue, iFormat ); println(); }
+
+private:
+  void prvWrite( const char *pcStr );
+  FILE *pxOut = NULL;
+  bool xAtLineStart = true;
+};
+
+extern HostSerial Serial;
+
+/* Time since the scheduler was started, derived from the tick count rather
+ * than the wall clock. The tick follows a host timer, so it is not
+ * repeatable across runs. */
+unsigned long millis( void );
+unsigned long micros( void );
+
+/* Sketch entry point. As on the Arduino FreeRTOS port, loop() is called
+ * from the idle hook. */
+void loop( void );
+
+#endif /* HOST_ARDUINO_H_ */
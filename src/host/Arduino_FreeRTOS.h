@@ -0,0 +1,9 @@
+#ifndef HOST_ARDUINO_FREERTOS_H_
+#define HOST_ARDUINO_FREERTOS_H_
+
+/* Host build replacement for the Arduino_FreeRTOS library header. The
+ * scheduler only needs the plain kernel, which is provided by the FreeRTOS
+ * POSIX/Linux port. */
+#include <FreeRTOS.h>
+
+#endif /* HOST_ARDUINO_FREERTOS_H_ */
@@ -0,0 +1,84 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* Kernel configuration for the host (FreeRTOS POSIX/Linux port) build.
+ * Values follow the Arduino Mega configuration where they influence the
+ * scheduler (four priorities, tick and idle hooks, no software timers). The tick type
+ * is 32 bit, since the POSIX port does not support 16 bit ticks, and the
+ * tick rate is 1 kHz so that pdMS_TO_TICKS() is exact. */
+
+#define configUSE_PREEMPTION                      1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION   0
+#define configUSE_IDLE_HOOK                       1
+#define configUSE_TICK_HOOK                       1
+#define configUSE_DAEMON_TASK_STARTUP_HOOK        0
+#define configTICK_RATE_HZ                        ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE                  ( ( unsigned short ) PTHREAD_STACK_MIN )
+#define configTOTAL_HEAP_SIZE                     ( ( size_t ) ( 256 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                   ( 12 )
+#define configUSE_TRACE_FACILITY                  0
+#define configUSE_16_BIT_TICKS                    0
+#define configIDLE_SHOULD_YIELD                   1
+#define configUSE_MUTEXES                         1
+#define configCHECK_FOR_STACK_OVERFLOW            0
+#define configUSE_RECURSIVE_MUTEXES               1
+#define configQUEUE_REGISTRY_SIZE                 0
+#define configUSE_MALLOC_FAILED_HOOK              0
+#define configUSE_APPLICATION_TASK_TAG            0
+#define configUSE_COUNTING_SEMAPHORES             1
+#define configUSE_TASK_NOTIFICATIONS              1
+/* Index 1 is used by the scheduler, see schedMODE_NOTIFICATION_INDEX. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES     2
+#define configMAX_PRIORITIES                      ( 4 )
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS   1
+#define configSUPPORT_DYNAMIC_ALLOCATION          1
+#define configSUPPORT_STATIC_ALLOCATION           0
+
+#define configUSE_TIMERS                          0
+
+#define INCLUDE_vTaskPrioritySet                  1
+#define INCLUDE_uxTaskPriorityGet                 1
+#define INCLUDE_vTaskDelete                       1
+#define INCLUDE_vTaskSuspend                      1
+#define INCLUDE_xTaskDelayUntil                   1
+#define INCLUDE_vTaskDelayUntil                   1
+#define INCLUDE_vTaskDelay                        1
+#define INCLUDE_xTaskGetIdleTaskHandle            1
+#define INCLUDE_xTaskGetCurrentTaskHandle         1
+#define INCLUDE_xTaskResumeFromISR                1
+#define INCLUDE_xTaskAbortDelay                   1
+
+/* The POSIX port needs PTHREAD_STACK_MIN for configMINIMAL_STACK_SIZE. */
+#include <limits.h>
+
+/* Static stacks need a constant size, which PTHREAD_STACK_MIN is not on
+ * glibc 2.34 and later. 128 KiB is above it on the common hosts. */
+#define schedSTATIC_STACK_DEPTH ( 131072 / sizeof( StackType_t ) )
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void vHostAssertCalled( const char *pcFile, unsigned long ulLine );
+  void vSchedulerTraceTaskSwitchedIn( void );
+  void vSchedulerTraceTaskSwitchedOut( void );
+  unsigned long ulHostMonotonicMicros( void );
+  unsigned long ulHostMonotonicNanos( void );
+#ifdef __cplusplus
+}
+#endif
+
+#define configASSERT( x ) if( ( x ) == 0 ) vHostAssertCalled( __FILE__, __LINE__ )
+
+/* Feeds task switches into the scheduling trace and the execution time
+ * measurement, see schedUSE_TRACE and schedUSE_SUBTICK_ACCOUNTING. */
+#define traceTASK_SWITCHED_IN() vSchedulerTraceTaskSwitchedIn()
+#define traceTASK_SWITCHED_OUT() vSchedulerTraceTaskSwitchedOut()
+
+/* micros() follows the tick count on the host, execution time is measured
+ * on the monotonic clock instead. */
+#define schedREAD_MICROS() ulHostMonotonicMicros()
+
+/* The scheduler overhead is measured in nanoseconds of host time. */
+#define schedREAD_OVERHEAD_CLOCK() ulHostMonotonicNanos()
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,6 @@
+#ifndef HOST_FREERTOS_VARIANT_H_
+#define HOST_FREERTOS_VARIANT_H_
+
+/* The AVR variant header has no equivalent on the POSIX port. */
+
+#endif /* HOST_FREERTOS_VARIANT_H_ */
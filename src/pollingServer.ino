@@ -6,16 +6,24 @@ TaskHandle_t xHandle2 = NULL;
 TaskHandle_t xAperiodicTaskHandle1 = NULL;
 TaskHandle_t xAperiodicTaskHandle2 = NULL;
 
-void loop() {}
+void loop() {
+  #if( schedUSE_EVENT_LOG == 1 )
+    vSchedulerLogFlush();
+  #endif /* schedUSE_EVENT_LOG */
+  #if( POLLING_SERVER_BACKGROUND_SERVICE == 1 )
+    vSchedulerBackgroundServe();
+  #endif /* POLLING_SERVER_BACKGROUND_SERVICE */
+}
+
+static void aperiodicTaskFunc1( void *pvParameters );
+static void aperiodicTaskFunc2( void *pvParameters );
 
 
-static void testFunc1( void *pvParameters ){
+void testFunc1( void *pvParameters ){
 
 	(void) pvParameters;
   int i, a;
-  Serial.begin(9600);
-  Serial.println("t1 start");
-  Serial.end();
+  vSchedulerLogMessage("t1 start");
   static int counter = 0;
   counter++;
  
@@ -28,9 +36,7 @@ static void testFunc1( void *pvParameters ){
     a = 1 + i*i*i*i;
   }
 
-  Serial.begin(9600);
-  Serial.println("t1 end");
-  Serial.end();
+  vSchedulerLogMessage("t1 end");
     
 }
 
@@ -39,17 +45,13 @@ static void aperiodicTaskFunc1( void *pvParameters ){
   (void) pvParameters;  
   float i, a;  
   
-  Serial.begin(9600);
-  Serial.println("Aperiodic Task 1 Start");
-  Serial.end();
+  vSchedulerLogMessage("Aperiodic Task 1 Start");
   
   for(i = 0; i < 10000; i++ )
   {
     a = 1 + a * a * i;  
   }  
-  Serial.begin(9600);
-  Serial.println("Aperiodic Task 1 End");
-  Serial.end();
+  vSchedulerLogMessage("Aperiodic Task 1 End");
 
 }
 
@@ -58,37 +60,29 @@ static void aperiodicTaskFunc2( void *pvParameters ){
   (void) pvParameters;  
   float i, a;  
   
-  Serial.begin(9600);
-  Serial.println("Aperiodic Task 2 Start");
-  Serial.end();
+  vSchedulerLogMessage("Aperiodic Task 2 Start");
   
   for(i = 0; i < 10000; i++ )
   {
     a = 1 + a * a * i;  
   }  
-  Serial.begin(9600);
-  Serial.println("Aperiodic Task 2 End");
-  Serial.end();
+  vSchedulerLogMessage("Aperiodic Task 2 End");
 
 }
 
 
-static void testFunc2( void *pvParameters ){
+void testFunc2( void *pvParameters ){
   
   (void) pvParameters;  
   float i, a;  
   
-  Serial.begin(9600);
-  Serial.println("t2 start");
-  Serial.end();
+  vSchedulerLogMessage("t2 start");
   
   for(i = 0; i < 10000; i++ )
   {
     a = 1 + i*i*i*i;
   }  
-  Serial.begin(9600);
-  Serial.println("t2 end");
-  Serial.end();
+  vSchedulerLogMessage("t2 end");
 
 }
 
@@ -97,12 +91,14 @@ static void testFunc2( void *pvParameters ){
 int main( void )
 {
 
-  char c1 = 'a';
-  char c2 = 'b';
-
   vSchedulerInit();
-  vSchedulerPeriodicTaskCreate(testFunc1, "t1", configMINIMAL_STACK_SIZE, &c1, 1, &xHandle1, pdMS_TO_TICKS(0), pdMS_TO_TICKS(800), pdMS_TO_TICKS(200), pdMS_TO_TICKS(800));  
-  vSchedulerPeriodicTaskCreate(testFunc2, "t2", configMINIMAL_STACK_SIZE, &c2, 2, &xHandle2, pdMS_TO_TICKS(0), pdMS_TO_TICKS(400), pdMS_TO_TICKS(200), pdMS_TO_TICKS(400));
+  #if( schedUSE_STATIC_TASK_SET == 0 )
+    char c1 = 'a';
+    char c2 = 'b';
+
+    vSchedulerPeriodicTaskCreate(testFunc1, "t1", configMINIMAL_STACK_SIZE, &c1, 1, &xHandle1, pdMS_TO_TICKS(0), pdMS_TO_TICKS(800), pdMS_TO_TICKS(200), pdMS_TO_TICKS(800));  
+    vSchedulerPeriodicTaskCreate(testFunc2, "t2", configMINIMAL_STACK_SIZE, &c2, 2, &xHandle2, pdMS_TO_TICKS(0), pdMS_TO_TICKS(400), pdMS_TO_TICKS(200), pdMS_TO_TICKS(400));
+  #endif /* schedUSE_STATIC_TASK_SET, otherwise the tasks are in taskSet.h */
 
   vSchedulerStart(); 
   for( ;; );
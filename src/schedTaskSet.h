@@ -0,0 +1,221 @@
+#ifndef SCHED_TASK_SET_H_
+#define SCHED_TASK_SET_H_
+
+/* Compile-time task set, used with schedUSE_STATIC_TASK_SET. The header
+ * named by schedTASK_SET_HEADER defines the periodic tasks as
+ *
+ *   static constexpr SchedTaskSpec_t xSchedTaskSet[] = { ... };
+ *
+ * and vSchedulerStart creates them in this order, followed by the polling
+ * server. The RMS or DMS priorities of all tasks, the polling server
+ * included, are ranked here at compile time as prvSetFixedPriorities does,
+ * and the set is checked with the same utilization bound and response-time
+ * analysis as the admission control. A set that fails them does not build.
+ *
+ * Only C++11 constexpr functions are used, so that the Arduino toolchain
+ * can evaluate them: each function is a single return statement, and loops
+ * are written as recursions over the task index. */
+
+/* Parameters of vSchedulerPeriodicTaskCreate, except the priority. */
+typedef struct schedTaskSpec
+{
+  TaskFunction_t pvTaskCode;
+  const char *pcName;
+  UBaseType_t uxStackDepth;
+  void *pvParameters;
+  TaskHandle_t *pxCreatedTask;
+  TickType_t xPhaseTick;
+  TickType_t xPeriodTick;
+  TickType_t xMaxExecTimeTick;
+  TickType_t xDeadlineTick;
+} SchedTaskSpec_t;
+
+#include schedTASK_SET_HEADER
+
+#if( schedSCHEDULING_POLICY != schedSCHEDULING_POLICY_RMS && schedSCHEDULING_POLICY != schedSCHEDULING_POLICY_DMS )
+  #error "schedUSE_STATIC_TASK_SET needs schedSCHEDULING_POLICY_RMS or schedSCHEDULING_POLICY_DMS"
+#endif
+
+/* Number of periodic tasks in xSchedTaskSet. */
+#define schedTASK_SET_PERIODIC_TASKS ( sizeof( xSchedTaskSet ) / sizeof( xSchedTaskSet[ 0 ] ) )
+
+/* Number of tasks of the scheduler, the polling server included. */
+#define schedTASK_SET_SIZE ( schedTASK_SET_PERIODIC_TASKS + POLLING_SERVER )
+
+/* Priority above the highest one given to a task. */
+#if( schedUSE_SCHEDULER_TASK == 1 )
+  #define schedTASK_SET_TOP_PRIORITY schedSCHEDULER_PRIORITY
+#else
+  #define schedTASK_SET_TOP_PRIORITY configMAX_PRIORITIES
+#endif /* schedUSE_SCHEDULER_TASK */
+
+#if( POLLING_SERVER == 1 )
+  /* The polling server, analysed as the last task of the set. */
+  static constexpr SchedTaskSpec_t xSchedTaskSetServer = { NULL, "Server", configMINIMAL_STACK_SIZE, NULL, NULL, 0,
+      POLLING_SERVER_PERIOD, POLLING_SERVER_MAX_EXEC_TIME, POLLING_SERVER_RELATIVE_DEADLINE };
+
+  /* Task uxIndex of the set. */
+  constexpr SchedTaskSpec_t xSchedTaskSetEntry( UBaseType_t uxIndex )
+  {
+    return ( uxIndex < schedTASK_SET_PERIODIC_TASKS ) ? xSchedTaskSet[ uxIndex ] : xSchedTaskSetServer;
+  }
+#else
+  constexpr SchedTaskSpec_t xSchedTaskSetEntry( UBaseType_t uxIndex )
+  {
+    return xSchedTaskSet[ uxIndex ];
+  }
+#endif /* POLLING_SERVER */
+
+/* Period or relative deadline of task uxIndex, whichever the policy ranks by. */
+constexpr TickType_t xSchedTaskSetRankKey( UBaseType_t uxIndex )
+{
+  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS )
+    return xSchedTaskSetEntry( uxIndex ).xPeriodTick;
+  #else
+    return xSchedTaskSetEntry( uxIndex ).xDeadlineTick;
+  #endif /* schedSCHEDULING_POLICY */
+}
+
+/* pdTRUE if a task before uxIndex has the same rank key. */
+constexpr BaseType_t xSchedTaskSetKeySeen( UBaseType_t uxIndex, UBaseType_t uxOther )
+{
+  return ( uxOther >= uxIndex ) ? pdFALSE :
+         ( xSchedTaskSetRankKey( uxOther ) == xSchedTaskSetRankKey( uxIndex ) ) ? pdTRUE :
+         xSchedTaskSetKeySeen( uxIndex, uxOther + 1 );
+}
+
+/* Number of distinct rank keys below xKey among the tasks from uxIndex on. */
+constexpr UBaseType_t uxSchedTaskSetShorterKeys( TickType_t xKey, UBaseType_t uxIndex )
+{
+  return ( uxIndex >= schedTASK_SET_SIZE ) ? 0 :
+         ( ( xSchedTaskSetRankKey( uxIndex ) < xKey && pdFALSE == xSchedTaskSetKeySeen( uxIndex, 0 ) ) ? 1 : 0 ) +
+         uxSchedTaskSetShorterKeys( xKey, uxIndex + 1 );
+}
+
+/* Priority of task uxIndex. Tasks with the same rank key share a priority,
+ * and each shorter key is one level higher. */
+constexpr UBaseType_t uxSchedTaskSetPriority( UBaseType_t uxIndex )
+{
+  return schedTASK_SET_TOP_PRIORITY - 1 - uxSchedTaskSetShorterKeys( xSchedTaskSetRankKey( uxIndex ), 0 );
+}
+
+/* pdTRUE if every task from uxIndex on gets a priority of at least
+ * tskIDLE_PRIORITY. */
+constexpr BaseType_t xSchedTaskSetPrioritiesFit( UBaseType_t uxIndex )
+{
+  return ( uxIndex >= schedTASK_SET_SIZE ) ? pdTRUE :
+         ( uxSchedTaskSetShorterKeys( xSchedTaskSetRankKey( uxIndex ), 0 ) + 1 > schedTASK_SET_TOP_PRIORITY - tskIDLE_PRIORITY ) ? pdFALSE :
+         xSchedTaskSetPrioritiesFit( uxIndex + 1 );
+}
+
+/* pdTRUE if every task from uxIndex on has a period and an execution time. */
+constexpr BaseType_t xSchedTaskSetIsValid( UBaseType_t uxIndex )
+{
+  return ( uxIndex >= schedTASK_SET_SIZE ) ? pdTRUE :
+         ( 0 == xSchedTaskSetEntry( uxIndex ).xPeriodTick || 0 == xSchedTaskSetEntry( uxIndex ).xMaxExecTimeTick ) ? pdFALSE :
+         xSchedTaskSetIsValid( uxIndex + 1 );
+}
+
+/* Utilization of the tasks from uxIndex on in per mille, each rounded down
+ * as in the admission control. */
+constexpr unsigned long ulSchedTaskSetUtilization( UBaseType_t uxIndex )
+{
+  return ( uxIndex >= schedTASK_SET_SIZE ) ? 0 :
+         ( unsigned long ) xSchedTaskSetEntry( uxIndex ).xMaxExecTimeTick * 1000UL / xSchedTaskSetEntry( uxIndex ).xPeriodTick +
+         ulSchedTaskSetUtilization( uxIndex + 1 );
+}
+
+/* Release jitter of task uxIndex. A deferrable server can use its budget at
+ * the end of one period and again at the start of the next, which is a
+ * jitter of T - C. */
+#if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_DEFERRABLE )
+  constexpr unsigned long ulSchedTaskSetJitter( UBaseType_t uxIndex )
+  {
+    return ( uxIndex == schedTASK_SET_PERIODIC_TASKS ) ?
+           ( unsigned long ) xSchedTaskSetEntry( uxIndex ).xPeriodTick - xSchedTaskSetEntry( uxIndex ).xMaxExecTimeTick : 0;
+  }
+#else
+  constexpr unsigned long ulSchedTaskSetJitter( UBaseType_t )
+  {
+    return 0;
+  }
+#endif /* POLLING_SERVER_MODE */
+
+/* Execution time that the tasks from uxOther on, other than uxIndex and with
+ * the same or a higher priority, can take within a window of ulWindow ticks. */
+constexpr unsigned long ulSchedTaskSetInterference( UBaseType_t uxIndex, unsigned long ulWindow, UBaseType_t uxOther )
+{
+  return ( uxOther >= schedTASK_SET_SIZE ) ? 0 :
+         ( ( uxOther != uxIndex && xSchedTaskSetRankKey( uxOther ) <= xSchedTaskSetRankKey( uxIndex ) ) ?
+           ( ( ulWindow + ulSchedTaskSetJitter( uxOther ) + xSchedTaskSetEntry( uxOther ).xPeriodTick - 1 ) / xSchedTaskSetEntry( uxOther ).xPeriodTick ) *
+           xSchedTaskSetEntry( uxOther ).xMaxExecTimeTick : 0 ) +
+         ulSchedTaskSetInterference( uxIndex, ulWindow, uxOther + 1 );
+}
+
+/* Response time of job ulJobs of the busy period that ends at ulWindow. */
+constexpr unsigned long ulSchedTaskSetJobResponse( UBaseType_t uxIndex, unsigned long ulJobs, unsigned long ulWindow )
+{
+  return ulWindow - ( ulJobs - 1 ) * xSchedTaskSetEntry( uxIndex ).xPeriodTick;
+}
+
+/* Iterates the end of job ulJobs of the busy period from ulWindow until it
+ * no longer moves, or the job exceeds ulLimit. */
+constexpr unsigned long ulSchedTaskSetWindowStep( UBaseType_t uxIndex, unsigned long ulJobs, unsigned long ulWindow,
+    unsigned long ulNext, unsigned long ulLimit )
+{
+  return ( ulNext == ulWindow || ulSchedTaskSetJobResponse( uxIndex, ulJobs, ulNext ) > ulLimit ) ? ulNext :
+         ulSchedTaskSetWindowStep( uxIndex, ulJobs, ulNext,
+             ulJobs * xSchedTaskSetEntry( uxIndex ).xMaxExecTimeTick + ulSchedTaskSetInterference( uxIndex, ulNext, 0 ), ulLimit );
+}
+
+constexpr unsigned long ulSchedTaskSetWindow( UBaseType_t uxIndex, unsigned long ulJobs, unsigned long ulLimit )
+{
+  return ulSchedTaskSetWindowStep( uxIndex, ulJobs, ulJobs * xSchedTaskSetEntry( uxIndex ).xMaxExecTimeTick,
+      ulJobs * xSchedTaskSetEntry( uxIndex ).xMaxExecTimeTick +
+      ulSchedTaskSetInterference( uxIndex, ulJobs * xSchedTaskSetEntry( uxIndex ).xMaxExecTimeTick, 0 ), ulLimit );
+}
+
+constexpr unsigned long ulSchedTaskSetResponseFrom( UBaseType_t uxIndex, unsigned long ulJobs, unsigned long ulWindow,
+    unsigned long ulResponse, unsigned long ulLimit );
+
+/* Worst-case response time of task uxIndex over the jobs of its busy period
+ * from ulJobs on, as prvResponseTime. Stops as soon as a response exceeds
+ * ulLimit, and returns that response. */
+constexpr unsigned long ulSchedTaskSetResponseTime( UBaseType_t uxIndex, unsigned long ulJobs, unsigned long ulResponse,
+    unsigned long ulLimit )
+{
+  return ulSchedTaskSetResponseFrom( uxIndex, ulJobs, ulSchedTaskSetWindow( uxIndex, ulJobs, ulLimit ), ulResponse, ulLimit );
+}
+
+constexpr unsigned long ulSchedTaskSetResponseFrom( UBaseType_t uxIndex, unsigned long ulJobs, unsigned long ulWindow,
+    unsigned long ulResponse, unsigned long ulLimit )
+{
+  return ( ulSchedTaskSetJobResponse( uxIndex, ulJobs, ulWindow ) > ulLimit ) ? ulSchedTaskSetJobResponse( uxIndex, ulJobs, ulWindow ) :
+         ( ulWindow <= ulJobs * xSchedTaskSetEntry( uxIndex ).xPeriodTick ) ?
+           ( ( ulSchedTaskSetJobResponse( uxIndex, ulJobs, ulWindow ) > ulResponse ) ? ulSchedTaskSetJobResponse( uxIndex, ulJobs, ulWindow ) : ulResponse ) :
+         ulSchedTaskSetResponseTime( uxIndex, ulJobs + 1,
+             ( ulSchedTaskSetJobResponse( uxIndex, ulJobs, ulWindow ) > ulResponse ) ? ulSchedTaskSetJobResponse( uxIndex, ulJobs, ulWindow ) : ulResponse,
+             ulLimit );
+}
+
+/* Worst-case response time of task uxIndex, exact up to its deadline. */
+constexpr unsigned long ulSchedTaskSetWorstCaseResponseTime( UBaseType_t uxIndex )
+{
+  return ulSchedTaskSetResponseTime( uxIndex, 1, 0, xSchedTaskSetEntry( uxIndex ).xDeadlineTick );
+}
+
+/* pdTRUE if every task from uxIndex on meets its deadline. */
+constexpr BaseType_t xSchedTaskSetMeetsDeadlines( UBaseType_t uxIndex )
+{
+  return ( uxIndex >= schedTASK_SET_SIZE ) ? pdTRUE :
+         ( ulSchedTaskSetWorstCaseResponseTime( uxIndex ) > xSchedTaskSetEntry( uxIndex ).xDeadlineTick ) ? pdFALSE :
+         xSchedTaskSetMeetsDeadlines( uxIndex + 1 );
+}
+
+static_assert( schedTASK_SET_PERIODIC_TASKS > 0, "xSchedTaskSet is empty" );
+static_assert( pdTRUE == xSchedTaskSetIsValid( 0 ), "A task of xSchedTaskSet has no period or no execution time" );
+static_assert( pdTRUE == xSchedTaskSetPrioritiesFit( 0 ), "xSchedTaskSet has more rank levels than priorities below the scheduler task" );
+static_assert( ulSchedTaskSetUtilization( 0 ) <= 1000UL, "xSchedTaskSet overloads the processor" );
+static_assert( pdTRUE == xSchedTaskSetMeetsDeadlines( 0 ), "A task of xSchedTaskSet misses its deadline" );
+
+#endif /* SCHED_TASK_SET_H_ */
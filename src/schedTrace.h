@@ -0,0 +1,36 @@
+#ifndef SCHED_TRACE_H_
+#define SCHED_TRACE_H_
+
+#include <stdint.h>
+
+/* Format of the binary scheduling trace, shared by the scheduler and the host
+ * side analyzer in tools/traceAnalyzer.cpp. A trace is a plain sequence of
+ * SchedTraceRecord_t records, 4 bytes each, stored little endian. */
+
+/* Task index of events that do not belong to a task of the scheduler, such as
+ * the idle task and the scheduler task being switched in. */
+#define schedTRACE_NO_TASK 0xFF
+
+/* Trace events. Unless noted otherwise, usTick is the tick of the event and
+ * ucTask the index of the task in the scheduler TCB array. */
+#define schedTRACE_RELEASE 1            /* Job released, usTick is its release time. */
+#define schedTRACE_START 2              /* Job started executing. */
+#define schedTRACE_FINISH 3             /* Job completed. */
+#define schedTRACE_SWITCHED_IN 4        /* Task switched in by the kernel. */
+#define schedTRACE_APERIODIC_START 5    /* Aperiodic job dequeued by the server task. */
+#define schedTRACE_APERIODIC_FINISH 6   /* Aperiodic job completed by the server task. */
+#define schedTRACE_DEADLINE_MISSED 7    /* Deadline missed, the task is recreated. */
+#define schedTRACE_BUDGET_EXHAUSTED 8   /* Worst-case execution time or server budget used up. */
+#define schedTRACE_SUSPEND 9            /* Task suspended by the scheduler task. */
+#define schedTRACE_RESUME 10            /* Task resumed by the scheduler task. */
+#define schedTRACE_REPLENISH 11         /* Sporadic server budget replenished. */
+#define schedTRACE_OVERFLOW 12          /* Records were lost before this one, ucTask is their number, at most 255. */
+
+typedef struct schedTraceRecord
+{
+  uint8_t ucEvent;    /* One of the schedTRACE_ events. */
+  uint8_t ucTask;     /* Task index, or schedTRACE_NO_TASK. */
+  uint16_t usTick;    /* Low 16 bits of the tick count. */
+} SchedTraceRecord_t;
+
+#endif /* SCHED_TRACE_H_ */
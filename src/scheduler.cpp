@@ -3,65 +3,366 @@
 #define schedTHREAD_LOCAL_STORAGE_POINTER_INDEX 0
 #define schedUSE_TCB_ARRAY 1
 
+/* Every periodic task (and the polling server) keeps a pointer to its extended
+ * TCB in this thread local storage slot, so it can be found in constant time. */
+#if( configNUM_THREAD_LOCAL_STORAGE_POINTERS <= schedTHREAD_LOCAL_STORAGE_POINTER_INDEX )
+  #error "configNUM_THREAD_LOCAL_STORAGE_POINTERS must be larger than schedTHREAD_LOCAL_STORAGE_POINTER_INDEX"
+#endif
+
+#if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+  #if( schedUSE_SCHEDULER_TASK != 1 )
+    #error "schedSCHEDULING_POLICY_EDF needs schedUSE_SCHEDULER_TASK"
+  #elif( configMAX_PRIORITIES < 4 )
+    #error "schedSCHEDULING_POLICY_EDF needs configMAX_PRIORITIES of at least 4"
+  #endif
+  #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+    #error "The sporadic server has no deadline, use POLLING_SERVER_MODE_CBS with schedSCHEDULING_POLICY_EDF"
+  #endif
+#elif( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+  #error "POLLING_SERVER_MODE_CBS needs schedSCHEDULING_POLICY_EDF"
+#endif
+
+#if( schedUSE_STATIC_ALLOCATION == 1 )
+  #if( configSUPPORT_STATIC_ALLOCATION != 1 )
+    #error "schedUSE_STATIC_ALLOCATION needs configSUPPORT_STATIC_ALLOCATION"
+  #elif( schedUSE_SCHEDULER_TASK != 1 )
+    #error "schedUSE_STATIC_ALLOCATION needs schedUSE_SCHEDULER_TASK"
+  #endif
+#endif /* schedUSE_STATIC_ALLOCATION */
+
+#if( schedUSE_BUDGET_TIMER == 1 )
+  #if( schedUSE_SUBTICK_ACCOUNTING != 1 )
+    #error "schedUSE_BUDGET_TIMER needs schedUSE_SUBTICK_ACCOUNTING"
+  #elif( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME != 1 || schedUSE_SCHEDULER_TASK != 1 )
+    #error "schedUSE_BUDGET_TIMER needs schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME and schedUSE_SCHEDULER_TASK"
+  #endif
+#endif /* schedUSE_BUDGET_TIMER */
+
+#if( schedUSE_OVERLOAD_POLICIES == 1 )
+  #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE != 1 )
+    #error "schedUSE_OVERLOAD_POLICIES needs schedUSE_TIMING_ERROR_DETECTION_DEADLINE"
+  #elif( schedUSE_SCHEDULER_TASK != 1 )
+    #error "schedUSE_OVERLOAD_POLICIES needs schedUSE_SCHEDULER_TASK"
+  #endif
+#endif /* schedUSE_OVERLOAD_POLICIES */
+
+/* Policies whose priorities are ranked by prvSetFixedPriorities. */
+#define schedFIXED_PRIORITY_POLICY ( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS || \
+                                     schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS || \
+                                     schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_OPA )
 
+/* The response-time analysis is used by the admission control of the
+ * fixed-priority policies, and by the optimal priority assignment. */
+#define schedUSE_RESPONSE_TIME_ANALYSIS ( ( schedUSE_ADMISSION_CONTROL == 1 && schedSCHEDULING_POLICY != schedSCHEDULING_POLICY_EDF ) || \
+                                          schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_OPA )
 
-/* Extended Task control block for managing periodic tasks within this library. */
+
+
+/* Extended Task control block for managing periodic tasks within this library.
+ * It only holds what the tick hook and the scheduler task use while the tasks
+ * run, the fields of the running task first. The creation parameters and the
+ * counters are kept apart in SchedTCBCold_t. */
 typedef struct xExtended_TCB
 {
-  TaskFunction_t pvTaskCode;    /* Function pointer to the code that will be run periodically. */
-  const char *pcName;       /* Name of the task. */
-  UBaseType_t uxStackDepth;       /* Stack size of the task. */
-  void *pvParameters;       /* Parameters to the task function. */
-  UBaseType_t uxPriority;     /* Priority of the task. */
-  TaskHandle_t *pxTaskHandle;   /* Task handle for the task. */
-  TickType_t xReleaseTime;    /* Release time of the task. */
-  TickType_t xRelativeDeadline; /* Relative deadline of the task. */
-  TickType_t xAbsoluteDeadline; /* Absolute deadline of the task. */
-  TickType_t xPeriod;       /* Task period. */
-  TickType_t xLastWakeTime;     /* Last time stamp when the task was running. */
-  TickType_t xMaxExecTime;    /* Worst-case execution time of the task. */
-  TickType_t xExecTime;     /* Current execution time of the task. */
+  #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+    unsigned long ulExecMicros;     /* Measured time that is not a whole tick of xExecTime yet. */
+    unsigned long ulJobExecMicros;  /* Measured execution time of the current job. */
+  #endif /* schedUSE_SUBTICK_ACCOUNTING */
 
-  BaseType_t xWorkIsDone;     /* pdFALSE if the job is not finished, pdTRUE if the job is finished. */
+  TickType_t xExecTime;     /* Current execution time of the task. */
+  TickType_t xMaxExecTime;    /* Worst-case execution time of the task. */
 
+  /* Flags that are only written before the task is created, with the kernel
+   * suspended, or by the scheduler task. */
   #if( schedUSE_TCB_ARRAY == 1 )
-    BaseType_t xPriorityIsSet;  /* pdTRUE if the priority is assigned. */
-    BaseType_t xInUse;      /* pdFALSE if this extended TCB is empty. */
+    uint8_t xPriorityIsSet : 1;  /* pdTRUE if the priority is assigned. */
+    uint8_t xInUse : 1;      /* pdFALSE if this extended TCB is empty. */
+  #endif
+  #if (POLLING_SERVER == 1)
+    uint8_t isPollingServer : 1;
   #endif
+  uint8_t : 0;
 
+  /* Budget flags. The tick hook and the budget timer only write them for the
+   * running task, which itself only writes them in a critical section, so no
+   * write to this byte is interrupted by another one. */
+  #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
+    uint8_t xSuspended : 1;    /* pdTRUE if the task is suspended. */
+    uint8_t xMaxExecTimeExceeded : 1; /* pdTRUE when execTime exceeds maxExecTime. */
+  #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
+  #if( schedUSE_OVERLOAD_POLICIES == 1 )
+    uint8_t xOverrunHandled : 1;    /* pdTRUE once the current job overran and was let run on. */
+    uint8_t xAbortJob : 1;          /* pdTRUE if the scheduler task aborts the overrunning job instead of suspending it. */
+  #endif /* schedUSE_OVERLOAD_POLICIES */
+
+  /* Written by the task and the scheduler task without a critical section, so
+   * each of these flags has its own byte. */
+  BaseType_t xWorkIsDone;     /* pdFALSE if the job is not finished, pdTRUE if the job is finished. */
   #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
     BaseType_t xExecutedOnce; /* pdTRUE if the task has executed once. */
   #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
 
+  TaskHandle_t *pxTaskHandle;   /* Task handle for the task. */
+  TickType_t xAbsoluteDeadline; /* Absolute deadline of the task. */
+  TickType_t xRelativeDeadline; /* Relative deadline of the task. */
+  TickType_t xPeriod;       /* Task period. */
+  TickType_t xLastWakeTime;     /* Last time stamp when the task was running. */
+  TickType_t xReleaseTime;    /* Release time of the task. */
+  UBaseType_t uxPriority;     /* Priority of the task. */
+
   #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 || schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
     TickType_t xAbsoluteUnblockTime; /* The task will be unblocked at this time if it is blocked by the scheduler task. */
   #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME || schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
 
-  #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
-    BaseType_t xSuspended;    /* pdTRUE if the task is suspended. */
-    BaseType_t xMaxExecTimeExceeded; /* pdTRUE when execTime exceeds maxExecTime. */
-  #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
-  
-  #if (POLLING_SERVER == 1)
-    BaseType_t isPollingServer;
-  #endif
+  #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+    TickType_t xNextEventTime;  /* Time at which the scheduler task must check this task next. */
+    BaseType_t xHeapPosition;   /* Position in the timing event heap, -1 if there is no pending event. */
+  #endif /* schedUSE_TIMING_EVENT_HEAP */
+
+  #if( schedUSE_MODE_CHANGE == 1 )
+    UBaseType_t uxModes;      /* Mask of the modes the task runs in. */
+    BaseType_t xDormant;      /* pdTRUE while the task waits for one of its modes. */
+  #endif /* schedUSE_MODE_CHANGE */
+
+  #if( schedUSE_OVERLOAD_POLICIES == 1 )
+    BaseType_t xMissHandled;        /* pdTRUE once the current job missed its deadline and was let run on. */
+  #endif /* schedUSE_OVERLOAD_POLICIES */
+
+  #if( schedUSE_ADMISSION_CONTROL == 1 )
+    TickType_t xWorstCaseResponseTime; /* Result of the last response-time analysis. */
+  #endif /* schedUSE_ADMISSION_CONTROL */
+
+  #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+    TickType_t xReplenishTime[ POLLING_SERVER_MAX_REPLENISHMENTS ];   /* Absolute times of pending replenishments, oldest first. */
+    TickType_t xReplenishAmount[ POLLING_SERVER_MAX_REPLENISHMENTS ]; /* Budget given back at the matching replenishment time. */
+    UBaseType_t uxReplenishHead;    /* Index of the oldest pending replenishment. */
+    UBaseType_t uxReplenishCount;   /* Number of pending replenishments. */
+    BaseType_t xChunkActive;        /* pdTRUE while the server is consuming budget. */
+    TickType_t xActivationTime;     /* Time at which the current consumption chunk started. */
+    TickType_t xChunkStartExecTime; /* xExecTime when the current consumption chunk started. */
+  #endif /* POLLING_SERVER_MODE */
   
 } SchedTCB_t;
 
+/* Size of SchedTCB_t with every option enabled and the sporadic server, for
+ * each target: 20 tick counts, and the other fields with their padding, 22
+ * bytes on the board and 15 words on a host. The bound is exact on the board
+ * and on a 64-bit host, so that a new field fails the build of the complete
+ * configuration in tools/schedScenarios.sh. A field that is only read when a
+ * task is created, a job ends or a task is reported on belongs in
+ * SchedTCBCold_t instead. */
+#if defined( __AVR__ )
+  #define schedTCB_MAX_SIZE ( 20 * sizeof( TickType_t ) + 22 )
+#else
+  #define schedTCB_MAX_SIZE ( 20 * sizeof( TickType_t ) + 15 * sizeof( void * ) )
+#endif
+static_assert( sizeof( SchedTCB_t ) <= schedTCB_MAX_SIZE, "SchedTCB_t has grown, move rarely used fields to SchedTCBCold_t" );
+
+/* Cold part of the extended TCB, in the slot of xTCBColdArray with the same
+ * index as the task in xTCBArray. Only used when a task is created, starts a
+ * job, or is reported on. */
+typedef struct xExtended_TCB_Cold
+{
+  TaskFunction_t pvTaskCode;    /* Function pointer to the code that will be run periodically. */
+  const char *pcName;       /* Name of the task. */
+  UBaseType_t uxStackDepth;       /* Stack size of the task. */
+  void *pvParameters;       /* Parameters to the task function. */
+
+  #if( schedUSE_OVERLOAD_POLICIES == 1 )
+    /* Only read when a job overruns, misses its deadline or completes. */
+    UBaseType_t uxOverloadPolicy;   /* One of the schedOVERLOAD_ policies. */
+    UBaseType_t uxFirmM;            /* At least uxFirmM of any uxFirmK consecutive jobs must meet their deadline. */
+    UBaseType_t uxFirmK;
+    uint16_t usFirmHistory;         /* Outcome of the last jobs, bit 0 is the latest, set if it met its deadline. */
+    SchedOverloadStats_t xOverloadStats;
+  #endif /* schedUSE_OVERLOAD_POLICIES */
+
+  #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+    SchedExecTimeStats_t xExecTimeStats;
+  #endif /* schedUSE_SUBTICK_ACCOUNTING */
+} SchedTCBCold_t;
+
 
 #if( POLLING_SERVER == 1)
 static TaskHandle_t pollingSeverTaskHandle = NULL;
 
+#if( ( schedMAX_NUMBER_OF_APERIODIC_TASKS & ( schedMAX_NUMBER_OF_APERIODIC_TASKS - 1 ) ) != 0 )
+  #error "schedMAX_NUMBER_OF_APERIODIC_TASKS must be a power of two"
+#endif
+
+/* Multi-producer, single-consumer ring of aperiodic jobs. queueHead and
+ * queueTail run freely and are only reduced modulo the capacity when used as
+ * an index. Producers reserve a slot inside a critical section of a few
+ * instructions, fill it with interrupts enabled, and then publish it through
+ * aperiodicJobReady. The consumer only takes published slots. */
 AJTCB_t aperiodicTCBQueue [schedMAX_NUMBER_OF_APERIODIC_TASKS] =  {0};
-BaseType_t queueHead = 0;
-BaseType_t queueTail = 0;
-BaseType_t aperiodicJobCounter = 0;
+static volatile BaseType_t aperiodicJobReady [schedMAX_NUMBER_OF_APERIODIC_TASKS] = {0};
+static volatile UBaseType_t queueHead = 0;
+static volatile UBaseType_t queueTail = 0;
+
+/* Keeps the compiler from moving the slot contents past its publication. */
+#define schedCOMPILER_BARRIER() __asm volatile( "" ::: "memory" )
+
+static BaseType_t prvEnqueueAperiodicJob( const AJTCB_t *pxNewJob, BaseType_t xFromISR, BaseType_t *pxHigherPriorityTaskWoken );
+static BaseType_t prvDequeueAperiodicJob( AJTCB_t *pxJob, TickType_t xBudget );
+static BaseType_t prvAperiodicJobFits( const AJTCB_t *pxJob, TickType_t xBudget );
+static TickType_t prvServerRemainingBudget( SchedTCB_t *pxTCB );
+static BaseType_t prvRunResumableAperiodicStep( TickType_t xBudget );
+
+/* Pending resumable jobs, oldest first. The oldest one is stepped until it
+ * completes. xResumableJobBusy is pdTRUE while one of the consumers runs a
+ * step, so that the server and the background service never run the same
+ * job at once. Only accessed with the scheduler suspended. */
+typedef struct resumableAperiodicJob
+{
+  AJStepFunction_t pxStepCode;
+  const char *pcName;
+  void *pvState;
+  TickType_t xStepExecTime;
+} AJResumable_t;
+
+static AJResumable_t xResumableJobs[ POLLING_SERVER_MAX_RESUMABLE_JOBS ];
+static UBaseType_t uxResumableJobs = 0;
+static BaseType_t xResumableJobBusy = pdFALSE;
+static void prvRecordAperiodicLateness( const AJTCB_t *pxJob );
+
+static AJLateness_t xAperiodicLateness = { 0 };
+
+#if( POLLING_SERVER_QUEUE_ORDER == POLLING_SERVER_QUEUE_EDF )
+  /* Jobs taken from the ring are kept in this binary min-heap, ordered by
+   * deadline. It is only accessed by the consumers, with the scheduler
+   * suspended. uxSequence keeps jobs with equal keys in arrival order. */
+  typedef struct aperiodicHeapNode
+  {
+    AJTCB_t xJob;
+    UBaseType_t uxSequence;
+  } AJHeapNode_t;
+
+  static AJHeapNode_t xAperiodicHeap[ schedMAX_NUMBER_OF_APERIODIC_TASKS ];
+  static UBaseType_t uxAperiodicHeapSize = 0;
+  static UBaseType_t uxAperiodicSequence = 0;
+
+  static BaseType_t prvAperiodicJobIsBefore( const AJHeapNode_t *pxA, const AJHeapNode_t *pxB );
+  static void prvAperiodicHeapPush( const AJTCB_t *pxJob );
+  static void prvAperiodicHeapRemove( UBaseType_t uxIndex, AJTCB_t *pxJob );
+#else
+  /* Jobs taken from the ring that did not fit the remaining server budget,
+   * oldest first. They are served before newer jobs once they fit. Only
+   * accessed by the consumers, with the scheduler suspended. */
+  static AJTCB_t xDeferredAperiodicJobs[ schedMAX_NUMBER_OF_APERIODIC_TASKS ];
+  static UBaseType_t uxDeferredAperiodicJobs = 0;
+#endif /* POLLING_SERVER_QUEUE_ORDER */
+
+#if( POLLING_SERVER_BACKGROUND_SERVICE == 1 )
+  static AJStats_t xAperiodicStats = { 0 };
+#endif /* POLLING_SERVER_BACKGROUND_SERVICE */
 #endif /* POLLING_SERVER */
 
 
 
+static SchedTCB_t *prvGetTCBFromHandle( TaskHandle_t xTaskHandle );
+static SchedTCBCold_t *prvGetColdTCB( SchedTCB_t *pxTCB );
+
+#if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+  /* Length of a tick in microseconds. */
+  #define schedMICROS_PER_TICK ( ( unsigned long ) portTICK_PERIOD_MS * 1000UL )
+
+  /* Time from which the running task has not been charged yet. */
+  static unsigned long ulChargedUntilMicros = 0;
+
+  static void prvChargeExecTime( SchedTCB_t *pxTCB, unsigned long ulNowMicros );
+  static void prvResetExecTime( SchedTCB_t *pxTCB );
+#endif /* schedUSE_SUBTICK_ACCOUNTING */
+
+#if( schedUSE_OVERHEAD_STATS == 1 )
+  static SchedOverheadStats_t xOverheadStats[ schedOVERHEAD_PARTS ] = { { 0 } };
+
+  static void prvRecordOverhead( UBaseType_t uxPart, unsigned long ulStart );
+#endif /* schedUSE_OVERHEAD_STATS */
+
+#if( schedUSE_BUDGET_TIMER == 1 )
+  #if defined( schedBUDGET_TIMER_ARM )
+    /* Provided by the build. */
+  #elif defined( __AVR__ )
+    /* Timer1 in normal mode with a prescaler of 64, 4 us per count at
+     * 16 MHz. The Arduino FreeRTOS port ticks on the watchdog timer and
+     * leaves Timer1 free. */
+    #define schedBUDGET_TIMER_MICROS_PER_COUNT ( 64000000UL / F_CPU )
+    #define schedBUDGET_TIMER_ARM( ulMicros ) prvBudgetTimerArm( ulMicros )
+    #define schedBUDGET_TIMER_DISARM() prvBudgetTimerDisarm()
+
+    static void prvBudgetTimerDisarm( void )
+    {
+      TCCR1B = 0;
+      TIMSK1 = 0;
+    }
+
+    /* A budget longer than the 16 bit counter is enforced in several timer
+     * periods, see xSchedulerBudgetTimerExpired. */
+    static void prvBudgetTimerArm( unsigned long ulMicros )
+    {
+      unsigned long ulCounts = ulMicros / schedBUDGET_TIMER_MICROS_PER_COUNT;
+
+      if( ulCounts > 0xFFFFUL )
+      {
+        ulCounts = 0xFFFFUL;
+      }
+      else if( 0 == ulCounts )
+      {
+        ulCounts = 1;
+      }
+      TCCR1B = 0;
+      TCCR1A = 0;
+      TCNT1 = 0;
+      OCR1A = ( uint16_t ) ulCounts;
+      TIFR1 = _BV( OCF1A );
+      TIMSK1 = _BV( OCIE1A );
+      TCCR1B = _BV( CS11 ) | _BV( CS10 );
+    }
+
+    ISR( TIMER1_COMPA_vect )
+    {
+      prvBudgetTimerDisarm();
+      if( pdTRUE == xSchedulerBudgetTimerExpired() )
+      {
+        /* Switch to the scheduler task now rather than at the next tick. */
+        portYIELD_FROM_ISR();
+      }
+    }
+  #else
+    /* No timer on this target, the expiry is rounded up to a tick and
+     * checked by the tick hook, which is no more precise than the check
+     * without the timer. The tick only compares the tick count, the running
+     * task is charged and checked when it is switched out or the budget
+     * expires. */
+    #define schedBUDGET_TIMER_ON_TICK 1
+    #define schedBUDGET_TIMER_ARM( ulMicros ) prvBudgetTimerArm( ulMicros )
+    #define schedBUDGET_TIMER_DISARM() ( xBudgetTimerArmed = pdFALSE )
+
+    static volatile BaseType_t xBudgetTimerArmed = pdFALSE;
+    static TickType_t xBudgetTimerExpiry = 0;
+
+    static void prvBudgetTimerArm( unsigned long ulMicros )
+    {
+      xBudgetTimerExpiry = xTaskGetTickCountFromISR() + ( TickType_t ) ( ( ulMicros + schedMICROS_PER_TICK - 1 ) / schedMICROS_PER_TICK );
+      xBudgetTimerArmed = pdTRUE;
+    }
+  #endif /* schedBUDGET_TIMER_ARM */
+#endif /* schedUSE_BUDGET_TIMER */
+
+#if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+  /* Extended TCB of the sporadic server, replenished from the tick hook. */
+  static SchedTCB_t *pxSporadicServerTCB = NULL;
+  static void prvSporadicServerCloseChunk( SchedTCB_t *pxTCB );
+  static void prvSporadicServerReplenish( SchedTCB_t *pxTCB, TickType_t xTickCount );
+  static BaseType_t prvAperiodicWorkPending( void );
+#endif /* POLLING_SERVER_MODE */
+
+#if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+  static void prvCBSActivate( SchedTCB_t *pxTCB, TickType_t xTickCount );
+#endif /* POLLING_SERVER_MODE */
+
 #if( schedUSE_TCB_ARRAY == 1 )
-  static BaseType_t prvGetTCBIndexFromHandle( TaskHandle_t xTaskHandle );
   static void prvInitTCBArray( void );
   /* Find index for an empty entry in xTCBArray. Return -1 if there is no empty entry. */
   static BaseType_t prvFindEmptyElementIndexTCB( void );
@@ -71,23 +372,142 @@ BaseType_t aperiodicJobCounter = 0;
 
 
 static TickType_t xSystemStartTime = 0;
+static BaseType_t xSchedulerStarted = pdFALSE;
+
+#if( schedUSE_MODE_CHANGE == 1 )
+  #if( schedMAX_NUMBER_OF_MODES > 8 )
+    #error schedMAX_NUMBER_OF_MODES must be at most 8
+  #endif
+  #if( configTASK_NOTIFICATION_ARRAY_ENTRIES <= schedMODE_NOTIFICATION_INDEX )
+    #error "schedUSE_MODE_CHANGE needs configTASK_NOTIFICATION_ARRAY_ENTRIES above schedMODE_NOTIFICATION_INDEX"
+  #endif
+
+  static volatile UBaseType_t uxCurrentMode = 0;
+  /* Time at which the tasks that joined with the last mode change are released. */
+  static TickType_t xModeReleaseTime = 0;
+  #if( POLLING_SERVER == 1 )
+    static TickType_t xModeServerBudget[ schedMAX_NUMBER_OF_MODES ];
+  #endif /* POLLING_SERVER */
+
+  static void prvWaitForMode( SchedTCB_t *pxTCB );
+#endif /* schedUSE_MODE_CHANGE */
+
+#if( schedUSE_MODE_CHANGE == 1 || schedUSE_OVERLOAD_POLICIES == 1 )
+  static SchedTCB_t *prvFindTCBByHandlePointer( TaskHandle_t *pxCreatedTask );
+#endif /* schedUSE_MODE_CHANGE || schedUSE_OVERLOAD_POLICIES */
+
+#if( schedUSE_OVERLOAD_POLICIES == 1 )
+  static void prvOverloadInit( SchedTCB_t *pxTCB );
+  static UBaseType_t prvFirmMetCount( uint16_t usHistory, UBaseType_t uxK );
+  static void prvFirmRecordMiss( SchedTCB_t *pxTCB );
+  static void prvOverloadJobDone( SchedTCB_t *pxTCB );
+#endif /* schedUSE_OVERLOAD_POLICIES */
+
+/* Events of the scheduler log. */
+#define schedLOG_DEADLINE_MISSED 1
+#define schedLOG_TASK_SUSPENDED 2
+#define schedLOG_TASK_RESUMED 3
+#define schedLOG_MESSAGE 4
+#define schedLOG_TASK_REJECTED 5
+#define schedLOG_TASK_SET_OVERLOADED 6
+#define schedLOG_FIRM_VIOLATED 7
+
+static void prvLogEvent( uint8_t ucEvent, SchedTCB_t *pxTCB, const char *pcMessage );
+
+#if( schedUSE_TRACE == 1 )
+  #if( ( schedTRACE_BUFFER_SIZE & ( schedTRACE_BUFFER_SIZE - 1 ) ) != 0 || schedTRACE_BUFFER_SIZE > 128 )
+    #error schedTRACE_BUFFER_SIZE must be a power of two and at most 128
+  #endif
+
+  /* Single consumer ring buffer, head and tail are free running. */
+  static SchedTraceRecord_t xTraceBuffer[ schedTRACE_BUFFER_SIZE ];
+  static volatile UBaseType_t uxTraceHead = 0;
+  static volatile UBaseType_t uxTraceTail = 0;
+  static volatile uint8_t ucTraceDropped = 0;
+
+  static void prvTraceEvent( uint8_t ucEvent, SchedTCB_t *pxTCB, TickType_t xTickCount, BaseType_t xFromISR );
+
+  /* Trace points compile to nothing when tracing is disabled. */
+  #define schedTRACE( ucEvent, pxTCB, xTickCount, xFromISR ) prvTraceEvent( ( ucEvent ), ( pxTCB ), ( xTickCount ), ( xFromISR ) )
+#else
+  #define schedTRACE( ucEvent, pxTCB, xTickCount, xFromISR )
+#endif /* schedUSE_TRACE */
+static void prvPrintLogEvent( uint8_t ucEvent, const char *pcText );
+
+#if( schedUSE_EVENT_LOG == 1 )
+  #if( ( schedEVENT_LOG_SIZE & ( schedEVENT_LOG_SIZE - 1 ) ) != 0 )
+    #error schedEVENT_LOG_SIZE must be a power of two
+  #endif
+
+  /* Record of the event log. Formatting is left to vSchedulerLogFlush. The
+   * task name is kept, not the TCB slot, which may be reused by another task
+   * before the record is printed. */
+  typedef struct schedLogRecord
+  {
+    const char *pcText;     /* Name of the task, or the text of schedLOG_MESSAGE records. */
+    TickType_t xTickCount;  /* Tick at which the event happened. */
+    uint8_t ucEvent;        /* One of the schedLOG_ events. */
+  } SchedLogRecord_t;
+
+  /* Single consumer ring buffer, head and tail are free running. */
+  static SchedLogRecord_t xEventLog[ schedEVENT_LOG_SIZE ];
+  static volatile UBaseType_t uxEventLogHead = 0;
+  static volatile UBaseType_t uxEventLogTail = 0;
+  static volatile unsigned long ulEventLogDropped = 0;
+#endif /* schedUSE_EVENT_LOG */
 
 static void prvPeriodicTaskCode( void *pvParameters );
+static BaseType_t prvCreateTask( SchedTCB_t *pxTCB );
 static void prvCreateAllTasks( void );
 
 
-#if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS)
+#if( schedFIXED_PRIORITY_POLICY )
   static void prvSetFixedPriorities( void );    
-#endif /* schedSCHEDULING_POLICY_RMS */
+#endif /* schedSCHEDULING_POLICY */
+static void prvApplyPriorities( void );
+
+static BaseType_t prvStartTaskAtRuntime( SchedTCB_t *pxTCB );
+
+#if( schedUSE_ADMISSION_CONTROL == 1 || schedUSE_RESPONSE_TIME_ANALYSIS )
+  static BaseType_t prvIsAnalysed( SchedTCB_t *pxTCB );
+  static TickType_t prvAnalysedExecTime( SchedTCB_t *pxTCB );
+#endif /* schedUSE_ADMISSION_CONTROL || schedUSE_RESPONSE_TIME_ANALYSIS */
+
+#if( schedUSE_RESPONSE_TIME_ANALYSIS )
+  static BaseType_t prvHasPriorityOver( SchedTCB_t *pxOtherTCB, SchedTCB_t *pxTCB );
+  static unsigned long prvInterference( SchedTCB_t *pxTCB, unsigned long ulWindow );
+  static unsigned long prvResponseTime( SchedTCB_t *pxTCB, unsigned long ulLimit );
+#endif /* schedUSE_RESPONSE_TIME_ANALYSIS */
+
+#if( schedUSE_ADMISSION_CONTROL == 1 )
+  static BaseType_t xAdmissionResult = schedADMISSION_OK;
+  static const char *pcAdmissionFailedTask = NULL;
+
+  static BaseType_t prvAnalyseTaskSet( SchedTCB_t **ppxFailedTCB );
+  static BaseType_t prvAdmitTaskSet( void );
+#endif /* schedUSE_ADMISSION_CONTROL */
 
 #if( schedUSE_SCHEDULER_TASK == 1 )
   static void prvSchedulerCheckTimingError( TickType_t xTickCount, SchedTCB_t *pxTCB );
   static void prvSchedulerFunction( void );
   static void prvCreateSchedulerTask( void );
   static void prvWakeScheduler( void );
+  static BaseType_t prvEnforceBudget( SchedTCB_t *pxCurrentTask, TickType_t xTickCount );
+
+  #if( schedUSE_BUDGET_TIMER == 1 )
+    static void prvBudgetTimerStart( SchedTCB_t *pxTCB );
+  #endif /* schedUSE_BUDGET_TIMER */
+
+  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+    static BaseType_t prvEDFIsReady( SchedTCB_t *pxTCB, TickType_t xTickCount );
+    static void prvEDFSetPriorities( TickType_t xTickCount );
+    static BaseType_t prvEDFReleaseDue( TickType_t xTickCount );
+    static void prvEDFReschedule( void );
+  #endif /* schedSCHEDULING_POLICY */
 
   #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
     static void prvPeriodicTaskRecreate( SchedTCB_t *pxTCB );
+    static void prvAbortJob( SchedTCB_t *pxTCB );
     static void prvDeadlineMissedHook( SchedTCB_t *pxTCB, TickType_t xTickCount );
     static void prvCheckDeadline( SchedTCB_t *pxTCB, TickType_t xTickCount );       
   #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
@@ -95,6 +515,13 @@ static void prvCreateAllTasks( void );
   #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
     static void prvExecTimeExceedHook( TickType_t xTickCount, SchedTCB_t *pxCurrentTask );
   #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
+
+  #if( schedUSE_TIMING_EVENT_HEAP == 1 )
+    static void prvTimingHeapSift( UBaseType_t uxPosition );
+    static void prvTimingHeapSet( SchedTCB_t *pxTCB, TickType_t xTime );
+    static void prvTimingHeapRemove( SchedTCB_t *pxTCB );
+    static void prvUpdateTimingEvent( SchedTCB_t *pxTCB );
+  #endif /* schedUSE_TIMING_EVENT_HEAP */
   
 #endif /* schedUSE_SCHEDULER_TASK */
 
@@ -103,356 +530,1846 @@ static void prvCreateAllTasks( void );
 #if( schedUSE_TCB_ARRAY == 1 )
   /* Array for extended TCBs. */
   static SchedTCB_t xTCBArray[ schedMAX_NUMBER_OF_PERIODIC_TASKS ] = { 0 };
+  static SchedTCBCold_t xTCBColdArray[ schedMAX_NUMBER_OF_PERIODIC_TASKS ];
   /* Counter for number of periodic tasks. */
   static BaseType_t xTaskCounter = 0;
 #endif /* schedUSE_TCB_ARRAY */
 
+#if( schedUSE_STATIC_ALLOCATION == 1 )
+  /* Stack and task buffer of the task in the TCB slot with the same index. */
+  static StackType_t xTaskStacks[ schedMAX_NUMBER_OF_PERIODIC_TASKS ][ schedSTATIC_STACK_DEPTH ];
+  static StaticTask_t xTaskBuffers[ schedMAX_NUMBER_OF_PERIODIC_TASKS ];
+  static StackType_t xSchedulerStack[ schedSCHEDULER_TASK_STACK_SIZE ];
+  static StaticTask_t xSchedulerTaskBuffer;
+  /* A task that deletes itself, to be deleted by the scheduler task. */
+  static TaskHandle_t xPendingDeleteHandle = NULL;
+#endif /* schedUSE_STATIC_ALLOCATION */
+
 #if( schedUSE_SCHEDULER_TASK )
   static TickType_t xSchedulerWakeCounter = 0;
   static TaskHandle_t xSchedulerHandle = NULL;
+
+  #if( schedUSE_TIMING_EVENT_HEAP == 1 )
+    /* Min-heap of the TCBs that have a pending timing event, ordered by
+     * xNextEventTime. Modified inside critical sections only, since the tick
+     * hook reads its root. */
+    static SchedTCB_t *pxTimingHeap[ schedMAX_NUMBER_OF_PERIODIC_TASKS ];
+    static UBaseType_t uxTimingHeapSize = 0;
+  #endif /* schedUSE_TIMING_EVENT_HEAP */
+
+  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+    /* Earliest release that is still to come, found by the last ranking. The
+     * tick hook only compares the tick count with it. */
+    static TickType_t xEDFNextRelease = 0;
+    static BaseType_t xEDFReleasePending = pdFALSE;
+  #endif /* schedSCHEDULING_POLICY */
 #endif /* schedUSE_SCHEDULER_TASK */
 
 
-#if( POLLING_SERVER == 1)
-  
-  /*void aperiodicTaskQueueInit(void) {
-    aperiodicJobsQueue = xQueueCreate(schedMAX_NUMBER_OF_APERIODIC_TASKS, sizeof(AJTCB_t));
-  }*/
-  
-  BaseType_t getEmptyIndexInQueue (void) {
-    BaseType_t retVal = -1;
-    
-    if(aperiodicJobCounter == schedMAX_NUMBER_OF_APERIODIC_TASKS)  {
-      /* Queue Full */
-      return retVal;
+#if( schedUSE_TRACE == 1 )
+  /* Appends a trace record. Interrupts are only masked while it is written.
+   * When the buffer is full the record is dropped and counted. */
+  static void prvTraceEvent( uint8_t ucEvent, SchedTCB_t *pxTCB, TickType_t xTickCount, BaseType_t xFromISR )
+  {
+    SchedTraceRecord_t *pxRecord;
+    UBaseType_t uxSavedInterruptStatus = 0;
+
+    if( pdTRUE == xFromISR ) {
+      uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    }
+    else {
+      taskENTER_CRITICAL();
     }
-    
-    retVal = queueTail;
-    
-    queueTail = (queueTail + 1) % schedMAX_NUMBER_OF_APERIODIC_TASKS;
-    
-    return retVal;
-  }
-  
-  
-  BaseType_t createAperiodicJob(TaskFunction_t pvTaskCode, \
-                const char *pcName, void *pvParameters, \
-                TaskHandle_t *pxCreatedTask) {
-    BaseType_t index;
- 
-    AJTCB_t *aperiodicTCB;
-  index = getEmptyIndexInQueue();
-  
-  if(index == -1) {
-    return pdFALSE;
-  }
-  
-  
-  aperiodicTCB = &aperiodicTCBQueue[index];
 
-    aperiodicTCB->pvTaskCode = pvTaskCode;
-    aperiodicTCB->pcName = pcName;
-    aperiodicTCB->pvParameters = pvParameters;
-    aperiodicTCB->pxTaskHandle = pxCreatedTask;
-  
-  aperiodicJobCounter++;
-  
-  return pdTRUE;
+    if( ( UBaseType_t ) ( uxTraceTail - uxTraceHead ) != schedTRACE_BUFFER_SIZE ) {
+      pxRecord = &xTraceBuffer[ uxTraceTail % schedTRACE_BUFFER_SIZE ];
+      pxRecord->ucEvent = ucEvent;
+      pxRecord->ucTask = ( NULL == pxTCB ) ? schedTRACE_NO_TASK : ( uint8_t ) ( pxTCB - xTCBArray );
+      pxRecord->usTick = ( uint16_t ) xTickCount;
+      uxTraceTail++;
+    }
+    else if( 0xFF != ucTraceDropped ) {
+      ucTraceDropped++;
+    }
+
+    if( pdTRUE == xFromISR ) {
+      taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+    else {
+      taskEXIT_CRITICAL();
+    }
   }
 
-  void executeAperiodicJob(void) {
-    BaseType_t retVal;
-    AJTCB_t *aperiodicTCB;
+  UBaseType_t uxSchedulerTraceRead( SchedTraceRecord_t *pxRecords, UBaseType_t uxMaxRecords )
+  {
+    UBaseType_t uxCount = 0;
 
-    /*Serial.begin(9600);
-    Serial.println("Polling Server Start");
-    Serial.end();*/
-      
-    for (; ; ) {
-      if(aperiodicJobCounter == 0) {
-        return;
-      } 
-      else {
-        aperiodicTCB = &aperiodicTCBQueue[queueHead];
-        queueHead = (queueHead + 1) % schedMAX_NUMBER_OF_APERIODIC_TASKS;
-        aperiodicJobCounter--;
-        aperiodicTCB -> pvTaskCode(aperiodicTCB -> pvParameters );
-      }
+    taskENTER_CRITICAL();
+    while( uxCount < uxMaxRecords && uxTraceHead != uxTraceTail ) {
+      pxRecords[ uxCount ] = xTraceBuffer[ uxTraceHead % schedTRACE_BUFFER_SIZE ];
+      uxTraceHead++;
+      uxCount++;
     }
+    /* Records are only dropped while the buffer is full, so the loss is
+     * reported once all buffered records have been read. */
+    if( 0 != ucTraceDropped && uxTraceHead == uxTraceTail && uxCount < uxMaxRecords ) {
+      pxRecords[ uxCount ].ucEvent = schedTRACE_OVERFLOW;
+      pxRecords[ uxCount ].ucTask = ucTraceDropped;
+      pxRecords[ uxCount ].usTick = ( uint16_t ) xTaskGetTickCount();
+      ucTraceDropped = 0;
+      uxCount++;
+    }
+    taskEXIT_CRITICAL();
+
+    return uxCount;
   }
-#endif /* POLLING_SERVER */
+#endif /* schedUSE_TRACE */
 
+void vSchedulerTraceTaskSwitchedIn( void )
+{
+  #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+    /* The time before was charged when the previous task was switched out. */
+    ulChargedUntilMicros = schedREAD_MICROS();
+  #endif /* schedUSE_SUBTICK_ACCOUNTING */
+  #if( schedUSE_BUDGET_TIMER == 1 )
+    prvBudgetTimerStart( prvGetTCBFromHandle( xTaskGetCurrentTaskHandle() ) );
+  #endif /* schedUSE_BUDGET_TIMER */
+  #if( schedUSE_TRACE == 1 )
+    /* Called by the kernel during the context switch, so the current task
+     * handle already refers to the task being switched in. */
+    schedTRACE( schedTRACE_SWITCHED_IN, prvGetTCBFromHandle( xTaskGetCurrentTaskHandle() ), xTaskGetTickCountFromISR(), pdTRUE );
+  #endif /* schedUSE_TRACE */
+}
 
-#if( schedUSE_TCB_ARRAY == 1 )
-  /* Returns index position in xTCBArray of TCB with same task handle as parameter. */
-  static BaseType_t prvGetTCBIndexFromHandle( TaskHandle_t xTaskHandle )
+void vSchedulerTraceTaskSwitchedOut( void )
+{
+  #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+    /* The current task handle still refers to the task being switched out.
+     * A deleted task has no TLS pointer left and is not charged. */
+    prvChargeExecTime( prvGetTCBFromHandle( xTaskGetCurrentTaskHandle() ), schedREAD_MICROS() );
+  #endif /* schedUSE_SUBTICK_ACCOUNTING */
+  #if( schedUSE_BUDGET_TIMER == 1 )
+    schedBUDGET_TIMER_DISARM();
+  #endif /* schedUSE_BUDGET_TIMER */
+}
+
+#if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+  /* Charges pxTCB, which is running or being switched out, with the time
+   * since it was last charged. Whole ticks are moved into xExecTime, which
+   * the budget checks use. Called with interrupts masked. */
+  static void prvChargeExecTime( SchedTCB_t *pxTCB, unsigned long ulNowMicros )
   {
-  static BaseType_t xIndex = 0;
-  BaseType_t xIterator;
+    unsigned long ulElapsed = ulNowMicros - ulChargedUntilMicros;
 
-    for( xIterator = 0; xIterator < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIterator++ )
+    ulChargedUntilMicros = ulNowMicros;
+    if( NULL == pxTCB )
     {
-    
-      if( pdTRUE == xTCBArray[ xIndex ].xInUse && *xTCBArray[ xIndex ].pxTaskHandle == xTaskHandle )
-      {
-        return xIndex;
-      }
-    
-      xIndex++;
-      if( schedMAX_NUMBER_OF_PERIODIC_TASKS == xIndex )
-      {
-        xIndex = 0;
-      }
+      return;
+    }
+    pxTCB->ulJobExecMicros += ulElapsed;
+    pxTCB->ulExecMicros += ulElapsed;
+    while( pxTCB->ulExecMicros >= schedMICROS_PER_TICK )
+    {
+      pxTCB->ulExecMicros -= schedMICROS_PER_TICK;
+      pxTCB->xExecTime++;
     }
-    return -1;
   }
 
-  /* Initializes xTCBArray. */
-  static void prvInitTCBArray( void )
+  /* Starts the measurement of a new job, and drops the remainder of the
+   * previous one. Only called when a job ends, or a task is created,
+   * recreated or joins a mode. The budget refills of the servers and of
+   * suspended tasks only reset xExecTime, so there ulExecMicros is kept,
+   * since it was used by the same job. */
+  static void prvResetExecTime( SchedTCB_t *pxTCB )
   {
-  UBaseType_t uxIndex;
-    for( uxIndex = 0; uxIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; uxIndex++)
+    pxTCB->ulExecMicros = 0;
+    pxTCB->ulJobExecMicros = 0;
+  }
+
+  void vSchedulerGetExecTimeStats( TaskHandle_t xTaskHandle, SchedExecTimeStats_t *pxStats )
+  {
+    SchedTCB_t *pxTCB = prvGetTCBFromHandle( xTaskHandle );
+
+    configASSERT( NULL != pxTCB );
+    if( NULL != pxTCB )
     {
-      xTCBArray[ uxIndex ].xInUse = pdFALSE;
+      taskENTER_CRITICAL();
+      *pxStats = prvGetColdTCB( pxTCB )->xExecTimeStats;
+      taskEXIT_CRITICAL();
     }
   }
+#endif /* schedUSE_SUBTICK_ACCOUNTING */
 
-  /* Find index for an empty entry in xTCBArray. Returns -1 if there is no empty entry. */
-  static BaseType_t prvFindEmptyElementIndexTCB( void )
+#if( schedUSE_OVERHEAD_STATS == 1 )
+  /* Charges the time since ulStart to uxPart. Called from tasks and from the
+   * tick hook. */
+  static void prvRecordOverhead( UBaseType_t uxPart, unsigned long ulStart )
   {
-  BaseType_t xIndex;
-    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    unsigned long ulElapsed = schedREAD_OVERHEAD_CLOCK() - ulStart;
+    SchedOverheadStats_t *pxStats = &xOverheadStats[ uxPart ];
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    pxStats->ulCalls++;
+    pxStats->ulTotal += ulElapsed;
+    if( ulElapsed > pxStats->ulMax )
     {
-      if( pdFALSE == xTCBArray[ xIndex ].xInUse )
-      {
-        return xIndex;
-      }
+      pxStats->ulMax = ulElapsed;
     }
-
-    return -1;
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
   }
 
-  /* Remove a pointer to extended TCB from xTCBArray. */
-  static void prvDeleteTCBFromArray( BaseType_t xIndex )
+  void vSchedulerGetOverheadStats( UBaseType_t uxPart, SchedOverheadStats_t *pxStats )
   {
-    configASSERT( xIndex >= 0 && xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS );
-    configASSERT( pdTRUE == xTCBArray[ xIndex ].xInUse );
-
-    if( xTCBArray[ pdTRUE == xIndex].xInUse )
+    configASSERT( uxPart < schedOVERHEAD_PARTS );
+    if( uxPart < schedOVERHEAD_PARTS )
     {
-      xTCBArray[ xIndex ].xInUse = pdFALSE;
-      xTaskCounter--;
+      taskENTER_CRITICAL();
+      *pxStats = xOverheadStats[ uxPart ];
+      taskEXIT_CRITICAL();
     }
   }
-  
-#endif /* schedUSE_TCB_ARRAY */
-
+#endif /* schedUSE_OVERHEAD_STATS */
 
-/* The whole function code that is executed by every periodic task.
- * This function wraps the task code specified by the user. */
-static void prvPeriodicTaskCode( void *pvParameters )
-{
-  SchedTCB_t *pxThisTask; 
-  TaskHandle_t xCurrentTaskHandle = xTaskGetCurrentTaskHandle();  
 
-    configASSERT( xCurrentTaskHandle );
-    
-  BaseType_t xIndex;
+#if( POLLING_SERVER == 1)
   
-  BaseType_t xFlag = 0;
+  /*void aperiodicTaskQueueInit(void) {
+    aperiodicJobsQueue = xQueueCreate(schedMAX_NUMBER_OF_APERIODIC_TASKS, sizeof(AJTCB_t));
+  }*/
   
-  for( xIndex = 0; xIndex < xTaskCounter; xIndex++ )
-  {
-    pxThisTask = &xTCBArray[ xIndex ];
-    if( uxTaskPriorityGet( xCurrentTaskHandle ) == pxThisTask->uxPriority){
-      xFlag = 1;
-      break;
-    } 
-  }
-  /*for (xIndex = 0; xIndex < xTaskCounter; xIndex++)
-    {
-        pxThisTask = &xTCBArray[xIndex];
-        if (*(pxThisTask->pxTaskHandle) == xCurrentTaskHandle) {
-            break;
-        }
-    }*/
+  /* Reserves the next free slot of the queue. Returns its index, or -1 if the
+   * queue is full. Interrupts are only masked for the reservation itself. */
+  BaseType_t getEmptyIndexInQueue (BaseType_t xFromISR) {
+    BaseType_t retVal = -1;
+    UBaseType_t uxSavedInterruptStatus = 0;
 
-  if( 0 != pxThisTask->xReleaseTime )
-  {
-    vTaskDelayUntil( &pxThisTask->xLastWakeTime, pxThisTask->xReleaseTime );
-  }
+    if( pdTRUE == xFromISR ) {
+      uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    }
+    else {
+      taskENTER_CRITICAL();
+    }
 
-  #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
-    pxThisTask->xExecutedOnce = pdTRUE;
-  #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
-  if( 0 == pxThisTask->xReleaseTime )
-  {
-    pxThisTask->xLastWakeTime = xSystemStartTime;
+    if( ( UBaseType_t ) ( queueTail - queueHead ) != schedMAX_NUMBER_OF_APERIODIC_TASKS ) {
+      retVal = ( BaseType_t ) ( queueTail % schedMAX_NUMBER_OF_APERIODIC_TASKS );
+      queueTail++;
+    }
+
+    if( pdTRUE == xFromISR ) {
+      taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    }
+    else {
+      taskEXIT_CRITICAL();
+    }
+
+    return retVal;
   }
 
-  for( ; ; )
-  {   
-    pxThisTask->xWorkIsDone = pdFALSE;    
+  /* Common part of all functions that create aperiodic jobs. */
+  static BaseType_t prvEnqueueAperiodicJob( const AJTCB_t *pxNewJob, BaseType_t xFromISR, BaseType_t *pxHigherPriorityTaskWoken ) {
+    BaseType_t index;
 
-    pxThisTask->xAbsoluteDeadline = pxThisTask->xLastWakeTime + pxThisTask->xRelativeDeadline;
+    index = getEmptyIndexInQueue( xFromISR );
+    if(index == -1) {
+      return pdFALSE;
+    }
 
-    /* Execute the task function specified by the user. */
-    pxThisTask->pvTaskCode( pvParameters );
-    pxThisTask->xWorkIsDone = pdTRUE;
+    aperiodicTCBQueue[index] = *pxNewJob;
 
-    //pxThisTask->xAbsoluteDeadline = pxThisTask->xLastWakeTime + pxThisTask->xRelativeDeadline + pxThisTask->xPeriod;
-    pxThisTask->xExecTime = 0;
-    vTaskDelayUntil( &pxThisTask->xLastWakeTime, pxThisTask->xPeriod );
-  }
-}
+    schedCOMPILER_BARRIER();
+    aperiodicJobReady[index] = pdTRUE;
+
+    #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_DEFERRABLE || POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC || POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+      /* Wake the server if it is waiting for jobs. */
+      if( NULL != pollingSeverTaskHandle )
+      {
+        if( pdTRUE == xFromISR )
+        {
+          vTaskNotifyGiveFromISR( pollingSeverTaskHandle, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+          xTaskNotifyGive( pollingSeverTaskHandle );
+        }
+      }
+    #else
+      ( void ) pxHigherPriorityTaskWoken;
+    #endif /* POLLING_SERVER_MODE */
+
+    return pdTRUE;
+  }
+  
+  BaseType_t createAperiodicJob(TaskFunction_t pvTaskCode, \
+                const char *pcName, void *pvParameters, \
+                TaskHandle_t *pxCreatedTask) {
+    AJTCB_t xJob = { pvTaskCode, pcName, pvParameters, pxCreatedTask, xTaskGetTickCount(), 0, 0, pdFALSE };
+
+    return prvEnqueueAperiodicJob( &xJob, pdFALSE, NULL );
+  }
+
+  BaseType_t xCreateAperiodicJobFromISR(TaskFunction_t pvTaskCode, \
+                const char *pcName, void *pvParameters, \
+                TaskHandle_t *pxCreatedTask, BaseType_t *pxHigherPriorityTaskWoken) {
+    AJTCB_t xJob = { pvTaskCode, pcName, pvParameters, pxCreatedTask, xTaskGetTickCountFromISR(), 0, 0, pdFALSE };
+
+    return prvEnqueueAperiodicJob( &xJob, pdTRUE, pxHigherPriorityTaskWoken );
+  }
+
+  BaseType_t xCreateAperiodicJobWithDeadline(TaskFunction_t pvTaskCode, \
+                const char *pcName, void *pvParameters, \
+                TaskHandle_t *pxCreatedTask, TickType_t xRelativeDeadline, TickType_t xMaxExecTime) {
+    TickType_t xTickCount = xTaskGetTickCount();
+    AJTCB_t xJob = { pvTaskCode, pcName, pvParameters, pxCreatedTask, xTickCount, ( TickType_t ) ( xTickCount + xRelativeDeadline ), xMaxExecTime, pdTRUE };
+
+    return prvEnqueueAperiodicJob( &xJob, pdFALSE, NULL );
+  }
+
+  BaseType_t xCreateAperiodicJobWithDeadlineFromISR(TaskFunction_t pvTaskCode, \
+                const char *pcName, void *pvParameters, \
+                TaskHandle_t *pxCreatedTask, TickType_t xRelativeDeadline, TickType_t xMaxExecTime, \
+                BaseType_t *pxHigherPriorityTaskWoken) {
+    TickType_t xTickCount = xTaskGetTickCountFromISR();
+    AJTCB_t xJob = { pvTaskCode, pcName, pvParameters, pxCreatedTask, xTickCount, ( TickType_t ) ( xTickCount + xRelativeDeadline ), xMaxExecTime, pdTRUE };
+
+    return prvEnqueueAperiodicJob( &xJob, pdTRUE, pxHigherPriorityTaskWoken );
+  }
+
+  BaseType_t xCreateResumableAperiodicJob(AJStepFunction_t pxStepCode, \
+                const char *pcName, void *pvState, TickType_t xStepExecTime) {
+    BaseType_t xReturn = pdFALSE;
+
+    /* A step must be known to fit a full budget, or it could not be run
+     * without being suspended halfway by prvExecTimeExceedHook. */
+    if( 0 == xStepExecTime || xStepExecTime > POLLING_SERVER_MAX_EXEC_TIME )
+    {
+      return pdFALSE;
+    }
+
+    vTaskSuspendAll();
+    if( POLLING_SERVER_MAX_RESUMABLE_JOBS != uxResumableJobs )
+    {
+      xResumableJobs[ uxResumableJobs ].pxStepCode = pxStepCode;
+      xResumableJobs[ uxResumableJobs ].pcName = pcName;
+      xResumableJobs[ uxResumableJobs ].pvState = pvState;
+      xResumableJobs[ uxResumableJobs ].xStepExecTime = xStepExecTime;
+      uxResumableJobs++;
+      xReturn = pdTRUE;
+    }
+    xTaskResumeAll();
+
+    #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_DEFERRABLE || POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC || POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+      /* Wake the server like prvEnqueueAperiodicJob does. An idle CBS gets
+       * its deadline from prvCBSActivate once it is woken. */
+      if( pdTRUE == xReturn && NULL != pollingSeverTaskHandle )
+      {
+        xTaskNotifyGive( pollingSeverTaskHandle );
+      }
+    #endif /* POLLING_SERVER_MODE */
+
+    return xReturn;
+  }
+
+  /* Runs one step of the oldest resumable job if the step fits xBudget.
+   * Returns pdTRUE if a step was run. The step runs with the scheduler
+   * running, so it is preempted and charged like any other server work. */
+  static BaseType_t prvRunResumableAperiodicStep( TickType_t xBudget )
+  {
+    AJResumable_t xJob;
+    BaseType_t xDone;
+    UBaseType_t uxIndex;
+
+    vTaskSuspendAll();
+    if( 0 == uxResumableJobs || pdTRUE == xResumableJobBusy )
+    {
+      ( void ) xTaskResumeAll();
+      return pdFALSE;
+    }
+    xJob = xResumableJobs[ 0 ];
+    /* Unlike queued jobs, a step is only started if it fits what is left.
+     * xStepExecTime is never 0, so no step starts on an empty budget. */
+    if( xJob.xStepExecTime > xBudget )
+    {
+      ( void ) xTaskResumeAll();
+      return pdFALSE;
+    }
+    xResumableJobBusy = pdTRUE;
+    ( void ) xTaskResumeAll();
+
+    xDone = xJob.pxStepCode( xJob.pvState );
+
+    vTaskSuspendAll();
+    if( pdTRUE == xDone )
+    {
+      uxResumableJobs--;
+      for( uxIndex = 0; uxIndex < uxResumableJobs; uxIndex++ )
+      {
+        xResumableJobs[ uxIndex ] = xResumableJobs[ uxIndex + 1 ];
+      }
+    }
+    xResumableJobBusy = pdFALSE;
+    ( void ) xTaskResumeAll();
+
+    return pdTRUE;
+  }
+
+  #if( POLLING_SERVER_QUEUE_ORDER == POLLING_SERVER_QUEUE_EDF )
+    /* Returns pdTRUE if job A must be served before job B. */
+    static BaseType_t prvAperiodicJobIsBefore( const AJHeapNode_t *pxA, const AJHeapNode_t *pxB )
+    {
+      if( pxA->xJob.xHasDeadline != pxB->xJob.xHasDeadline )
+      {
+        return pxA->xJob.xHasDeadline;
+      }
+      if( pdTRUE == pxA->xJob.xHasDeadline && pxA->xJob.xAbsoluteDeadline != pxB->xJob.xAbsoluteDeadline )
+      {
+        return ( ( signed ) ( pxA->xJob.xAbsoluteDeadline - pxB->xJob.xAbsoluteDeadline ) < 0 ) ? pdTRUE : pdFALSE;
+      }
+      return ( ( BaseType_t ) ( UBaseType_t ) ( pxA->uxSequence - pxB->uxSequence ) < 0 ) ? pdTRUE : pdFALSE;
+    }
+
+    static void prvAperiodicHeapPush( const AJTCB_t *pxJob )
+    {
+      UBaseType_t uxIndex = uxAperiodicHeapSize++;
+      AJHeapNode_t xNode = { *pxJob, uxAperiodicSequence++ };
+
+      /* Sift up. */
+      while( uxIndex > 0 && pdTRUE == prvAperiodicJobIsBefore( &xNode, &xAperiodicHeap[ ( uxIndex - 1 ) / 2 ] ) )
+      {
+        xAperiodicHeap[ uxIndex ] = xAperiodicHeap[ ( uxIndex - 1 ) / 2 ];
+        uxIndex = ( uxIndex - 1 ) / 2;
+      }
+      xAperiodicHeap[ uxIndex ] = xNode;
+    }
+
+    /* Removes the node at uxIndex from the heap and copies its job into pxJob. */
+    static void prvAperiodicHeapRemove( UBaseType_t uxIndex, AJTCB_t *pxJob )
+    {
+      UBaseType_t uxChild;
+      AJHeapNode_t xLast = xAperiodicHeap[ --uxAperiodicHeapSize ];
+
+      *pxJob = xAperiodicHeap[ uxIndex ].xJob;
+      if( uxIndex == uxAperiodicHeapSize )
+      {
+        return;
+      }
+
+      /* Move the last node into the hole. Sift it up if it is before the
+       * parent of the hole, otherwise sift it down. */
+      while( uxIndex > 0 && pdTRUE == prvAperiodicJobIsBefore( &xLast, &xAperiodicHeap[ ( uxIndex - 1 ) / 2 ] ) )
+      {
+        xAperiodicHeap[ uxIndex ] = xAperiodicHeap[ ( uxIndex - 1 ) / 2 ];
+        uxIndex = ( uxIndex - 1 ) / 2;
+      }
+      for( ; ; )
+      {
+        uxChild = 2 * uxIndex + 1;
+        if( uxChild >= uxAperiodicHeapSize )
+        {
+          break;
+        }
+        if( uxChild + 1 < uxAperiodicHeapSize && pdTRUE == prvAperiodicJobIsBefore( &xAperiodicHeap[ uxChild + 1 ], &xAperiodicHeap[ uxChild ] ) )
+        {
+          uxChild++;
+        }
+        if( pdFALSE == prvAperiodicJobIsBefore( &xAperiodicHeap[ uxChild ], &xLast ) )
+        {
+          break;
+        }
+        xAperiodicHeap[ uxIndex ] = xAperiodicHeap[ uxChild ];
+        uxIndex = uxChild;
+      }
+      xAperiodicHeap[ uxIndex ] = xLast;
+    }
+  #endif /* POLLING_SERVER_QUEUE_ORDER */
+
+  /* Records the lateness of a completed job that has a deadline. The server
+   * and the background service may both complete jobs. */
+  static void prvRecordAperiodicLateness( const AJTCB_t *pxJob )
+  {
+    TickType_t xLateness;
+    UBaseType_t uxBucket = 0;
+
+    if( pdFALSE == pxJob->xHasDeadline )
+    {
+      return;
+    }
+
+    xLateness = xTaskGetTickCount() - pxJob->xAbsoluteDeadline;
+    if( ( signed ) xLateness <= 0 )
+    {
+      xLateness = 0;
+    }
+    while( xLateness >> uxBucket != 0 && uxBucket < POLLING_SERVER_LATENESS_BUCKETS - 1 )
+    {
+      uxBucket++;
+    }
+
+    taskENTER_CRITICAL();
+    xAperiodicLateness.ulJobs++;
+    if( 0 != xLateness )
+    {
+      xAperiodicLateness.ulLateJobs++;
+    }
+    if( xLateness > xAperiodicLateness.xMaxLateness )
+    {
+      xAperiodicLateness.xMaxLateness = xLateness;
+    }
+    xAperiodicLateness.ulHistogram[ uxBucket ]++;
+    taskEXIT_CRITICAL();
+  }
+
+  void vSchedulerGetAperiodicLateness( AJLateness_t *pxLateness )
+  {
+    taskENTER_CRITICAL();
+    *pxLateness = xAperiodicLateness;
+    taskEXIT_CRITICAL();
+  }
+
+  /* Returns pdTRUE if the job can run to completion within xBudget ticks.
+   * Jobs without an estimated execution time always fit, and so does every
+   * job when the budget is full, so that long jobs are not starved. */
+  static BaseType_t prvAperiodicJobFits( const AJTCB_t *pxJob, TickType_t xBudget )
+  {
+    if( 0 == pxJob->xMaxExecTime || pxJob->xMaxExecTime <= xBudget || xBudget >= POLLING_SERVER_MAX_EXEC_TIME )
+    {
+      return pdTRUE;
+    }
+    return pdFALSE;
+  }
+
+  /* Returns the budget the server has left in the current period. */
+  static TickType_t prvServerRemainingBudget( SchedTCB_t *pxTCB )
+  {
+    TickType_t xExecTime;
+
+    #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+      /* The CBS recharges an exhausted budget at once, so every job fits. */
+      ( void ) pxTCB;
+      ( void ) xExecTime;
+      return portMAX_DELAY;
+    #endif /* POLLING_SERVER_MODE */
+
+    /* xExecTime is updated by the tick hook. */
+    taskENTER_CRITICAL();
+    #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+      /* Called by the server itself, which is charged at switches only. */
+      prvChargeExecTime( pxTCB, schedREAD_MICROS() );
+    #endif /* schedUSE_SUBTICK_ACCOUNTING */
+    xExecTime = pxTCB->xExecTime;
+    taskEXIT_CRITICAL();
+
+    return ( xExecTime < pxTCB->xMaxExecTime ) ? pxTCB->xMaxExecTime - xExecTime : 0;
+  }
+
+  /* Removes the next job that fits xBudget from the queue and copies it into
+   * pxJob, so the slot can be reused while the job runs. Jobs that do not fit
+   * stay queued for later. Returns pdFALSE if no published job fits. The
+   * server and the background service may both dequeue, so the consumer side
+   * runs with the scheduler suspended. Producers only touch queueTail and
+   * unpublished slots, so interrupts stay enabled. */
+  static BaseType_t prvDequeueAperiodicJob( AJTCB_t *pxJob, TickType_t xBudget )
+  {
+    BaseType_t xReturn = pdFALSE;
+    UBaseType_t uxIndex;
+
+    vTaskSuspendAll();
+    #if( POLLING_SERVER_QUEUE_ORDER == POLLING_SERVER_QUEUE_EDF )
+      BaseType_t xBest = -1;
+
+      /* Move every published job into the heap. */
+      for( ; ; )
+      {
+        uxIndex = queueHead % schedMAX_NUMBER_OF_APERIODIC_TASKS;
+        if( queueHead == queueTail || pdFALSE == aperiodicJobReady[ uxIndex ] || schedMAX_NUMBER_OF_APERIODIC_TASKS == uxAperiodicHeapSize )
+        {
+          break;
+        }
+        prvAperiodicHeapPush( &aperiodicTCBQueue[ uxIndex ] );
+        aperiodicJobReady[ uxIndex ] = pdFALSE;
+        queueHead++;
+      }
+
+      /* Serve the earliest deadline among the jobs that fit. */
+      for( uxIndex = 0; uxIndex < uxAperiodicHeapSize; uxIndex++ )
+      {
+        if( pdTRUE == prvAperiodicJobFits( &xAperiodicHeap[ uxIndex ].xJob, xBudget ) &&
+            ( -1 == xBest || pdTRUE == prvAperiodicJobIsBefore( &xAperiodicHeap[ uxIndex ], &xAperiodicHeap[ xBest ] ) ) )
+        {
+          xBest = ( BaseType_t ) uxIndex;
+        }
+      }
+      if( -1 != xBest )
+      {
+        prvAperiodicHeapRemove( ( UBaseType_t ) xBest, pxJob );
+        xReturn = pdTRUE;
+      }
+    #else
+      /* Deferred jobs are older than the ones in the ring, so try them first. */
+      for( uxIndex = 0; uxIndex < uxDeferredAperiodicJobs; uxIndex++ )
+      {
+        if( pdTRUE == prvAperiodicJobFits( &xDeferredAperiodicJobs[ uxIndex ], xBudget ) )
+        {
+          *pxJob = xDeferredAperiodicJobs[ uxIndex ];
+          uxDeferredAperiodicJobs--;
+          for( ; uxIndex < uxDeferredAperiodicJobs; uxIndex++ )
+          {
+            xDeferredAperiodicJobs[ uxIndex ] = xDeferredAperiodicJobs[ uxIndex + 1 ];
+          }
+          xReturn = pdTRUE;
+          break;
+        }
+      }
+
+      while( pdFALSE == xReturn )
+      {
+        uxIndex = queueHead % schedMAX_NUMBER_OF_APERIODIC_TASKS;
+        if( queueHead == queueTail || pdFALSE == aperiodicJobReady[ uxIndex ] )
+        {
+          break;
+        }
+        if( pdTRUE == prvAperiodicJobFits( &aperiodicTCBQueue[ uxIndex ], xBudget ) )
+        {
+          *pxJob = aperiodicTCBQueue[ uxIndex ];
+          xReturn = pdTRUE;
+        }
+        else if( schedMAX_NUMBER_OF_APERIODIC_TASKS != uxDeferredAperiodicJobs )
+        {
+          xDeferredAperiodicJobs[ uxDeferredAperiodicJobs++ ] = aperiodicTCBQueue[ uxIndex ];
+        }
+        else
+        {
+          break;
+        }
+        aperiodicJobReady[ uxIndex ] = pdFALSE;
+        queueHead++;
+      }
+    #endif /* POLLING_SERVER_QUEUE_ORDER */
+    xTaskResumeAll();
+
+    return xReturn;
+  }
+
+  void executeAperiodicJob(void) {
+    AJTCB_t aperiodicTCB;
+    TickType_t xBudget;
+
+    SchedTCB_t *pxServerTCB = prvGetTCBFromHandle( NULL );
+
+    #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_DEFERRABLE )
+      TickType_t xPeriodEnd, xTickCount;
+    #endif /* POLLING_SERVER_MODE */
+
+    /*Serial.begin(9600);
+    Serial.println("Polling Server Start");
+    Serial.end();*/
+
+    #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+      /* The first run can start long after the release that set the initial
+       * deadline, when the server only runs once the other tasks are done.
+       * It activates the CBS like every later arrival, so that it does not
+       * serve with a deadline in the past. */
+      prvCBSActivate( pxServerTCB, xTaskGetTickCount() );
+      prvEDFReschedule();
+    #endif /* POLLING_SERVER_MODE */
+      
+    for (; ; ) {
+      /* Only start jobs that can finish within the remaining budget, instead
+       * of being suspended halfway by prvExecTimeExceedHook. */
+      xBudget = prvServerRemainingBudget( pxServerTCB );
+      if( pdTRUE == prvDequeueAperiodicJob( &aperiodicTCB, xBudget ) ) {
+        schedTRACE( schedTRACE_APERIODIC_START, pxServerTCB, xTaskGetTickCount(), pdFALSE );
+        aperiodicTCB.pvTaskCode( aperiodicTCB.pvParameters );
+        schedTRACE( schedTRACE_APERIODIC_FINISH, pxServerTCB, xTaskGetTickCount(), pdFALSE );
+        prvRecordAperiodicLateness( &aperiodicTCB );
+        #if( POLLING_SERVER_BACKGROUND_SERVICE == 1 )
+          xAperiodicStats.ulServerJobs++;
+        #endif /* POLLING_SERVER_BACKGROUND_SERVICE */
+      }
+      /* Resumable jobs only get the budget that queued jobs leave unused. */
+      else if( pdFALSE == prvRunResumableAperiodicStep( xBudget ) ) {
+        #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_DEFERRABLE )
+          /* Budget that is not used yet is kept until the end of the period.
+           * xExecTime is only charged while jobs run, and it is reset at the
+           * next release, which refills the budget. */
+          xPeriodEnd = pxServerTCB->xLastWakeTime + pxServerTCB->xPeriod;
+          xTickCount = xTaskGetTickCount();
+          if( ( signed ) ( xPeriodEnd - xTickCount ) <= 0 )
+          {
+            return;
+          }
+          ulTaskNotifyTake( pdTRUE, xPeriodEnd - xTickCount );
+          continue;
+        #elif( POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+          /* The sporadic server is not bound to its period. It goes idle,
+           * schedules the replenishment of what it has consumed, and runs
+           * again as soon as a job arrives. This function never returns, so
+           * xExecTime is only given back by replenishments. */
+          taskENTER_CRITICAL();
+          #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+            prvChargeExecTime( pxServerTCB, schedREAD_MICROS() );
+          #endif /* schedUSE_SUBTICK_ACCOUNTING */
+          prvSporadicServerCloseChunk( pxServerTCB );
+          taskEXIT_CRITICAL();
+          ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+          continue;
+        #elif( POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+          /* Like the sporadic server, the CBS never returns. It leaves the
+           * EDF ranking while it is idle, and gets a deadline by the CBS
+           * rule when the next job arrives. */
+          pxServerTCB->xWorkIsDone = pdTRUE;
+          prvEDFReschedule();
+          ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+          prvCBSActivate( pxServerTCB, xTaskGetTickCount() );
+          prvEDFReschedule();
+          continue;
+        #else
+          return;
+        #endif /* POLLING_SERVER_MODE */
+      }
+    }
+  }
+
+  #if( POLLING_SERVER_BACKGROUND_SERVICE == 1 )
+    /* Runs at most one queued job, so that the idle task still gets to clean
+     * up deleted tasks between jobs. The idle task has no extended TCB, so
+     * nothing is charged to the server budget. */
+    void vSchedulerBackgroundServe( void )
+    {
+      AJTCB_t xJob;
+
+      /* Background jobs are not limited by the server budget. */
+      if( pdTRUE == prvDequeueAperiodicJob( &xJob, portMAX_DELAY ) )
+      {
+        xJob.pvTaskCode( xJob.pvParameters );
+        prvRecordAperiodicLateness( &xJob );
+        taskENTER_CRITICAL();
+        xAperiodicStats.ulBackgroundJobs++;
+        taskEXIT_CRITICAL();
+      }
+      else
+      {
+        ( void ) prvRunResumableAperiodicStep( portMAX_DELAY );
+      }
+    }
+
+    void vSchedulerGetAperiodicStats( AJStats_t *pxStats )
+    {
+      taskENTER_CRITICAL();
+      *pxStats = xAperiodicStats;
+      taskEXIT_CRITICAL();
+    }
+  #endif /* POLLING_SERVER_BACKGROUND_SERVICE */
+
+  #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+    /* Ends the current consumption chunk of the sporadic server and schedules
+     * the replenishment of the consumed budget one period after the chunk
+     * started. Must be called from the tick hook or inside a critical section. */
+    static void prvSporadicServerCloseChunk( SchedTCB_t *pxTCB )
+    {
+      TickType_t xAmount, xTime;
+      UBaseType_t uxIndex;
+
+      if( pdFALSE == pxTCB->xChunkActive )
+      {
+        return;
+      }
+      pxTCB->xChunkActive = pdFALSE;
+
+      xAmount = pxTCB->xExecTime - pxTCB->xChunkStartExecTime;
+      xTime = pxTCB->xActivationTime + pxTCB->xPeriod;
+      if( 0 == xAmount )
+      {
+        return;
+      }
+
+      if( POLLING_SERVER_MAX_REPLENISHMENTS == pxTCB->uxReplenishCount )
+      {
+        /* Merge into the latest entry. Its budget comes back later than it
+         * would otherwise, which never breaks the schedulability analysis. */
+        uxIndex = ( pxTCB->uxReplenishHead + pxTCB->uxReplenishCount - 1 ) % POLLING_SERVER_MAX_REPLENISHMENTS;
+        pxTCB->xReplenishTime[ uxIndex ] = xTime;
+        pxTCB->xReplenishAmount[ uxIndex ] += xAmount;
+        return;
+      }
+
+      uxIndex = ( pxTCB->uxReplenishHead + pxTCB->uxReplenishCount ) % POLLING_SERVER_MAX_REPLENISHMENTS;
+      pxTCB->xReplenishTime[ uxIndex ] = xTime;
+      pxTCB->xReplenishAmount[ uxIndex ] = xAmount;
+      pxTCB->uxReplenishCount++;
+    }
+
+    /* Gives back all replenishments that are due. Called every tick. */
+    static void prvSporadicServerReplenish( SchedTCB_t *pxTCB, TickType_t xTickCount )
+    {
+      BaseType_t xReplenished = pdFALSE;
+      BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+      while( 0 != pxTCB->uxReplenishCount &&
+             ( signed ) ( pxTCB->xReplenishTime[ pxTCB->uxReplenishHead ] - xTickCount ) <= 0 )
+      {
+        TickType_t xAmount = pxTCB->xReplenishAmount[ pxTCB->uxReplenishHead ];
+
+        pxTCB->xExecTime = ( pxTCB->xExecTime > xAmount ) ? pxTCB->xExecTime - xAmount : 0;
+        if( pdTRUE == pxTCB->xChunkActive )
+        {
+          /* Keep the consumption of the running chunk unchanged. */
+          pxTCB->xChunkStartExecTime = ( pxTCB->xChunkStartExecTime > xAmount ) ? pxTCB->xChunkStartExecTime - xAmount : 0;
+        }
+        pxTCB->uxReplenishHead = ( pxTCB->uxReplenishHead + 1 ) % POLLING_SERVER_MAX_REPLENISHMENTS;
+        pxTCB->uxReplenishCount--;
+        xReplenished = pdTRUE;
+        schedTRACE( schedTRACE_REPLENISH, pxTCB, xTickCount, pdTRUE );
+      }
+
+      /* An idle server only waits for new jobs. Jobs it deferred because they
+       * did not fit the budget may fit now, so wake it to look again. The
+       * tick switches to it once the hook returns. */
+      if( pdTRUE == xReplenished && pdFALSE == pxTCB->xChunkActive && pdFALSE == pxTCB->xSuspended &&
+          pdTRUE == prvAperiodicWorkPending() )
+      {
+        vTaskNotifyGiveFromISR( pollingSeverTaskHandle, &xHigherPriorityTaskWoken );
+      }
+    }
+
+    /* Returns pdTRUE if jobs or steps are waiting for the server. Read from
+     * the tick hook without suspending the scheduler: the counts only change
+     * while a consumer runs, and a stale answer costs the server one more
+     * look at the queue. */
+    static BaseType_t prvAperiodicWorkPending( void )
+    {
+      #if( POLLING_SERVER_QUEUE_ORDER == POLLING_SERVER_QUEUE_EDF )
+        if( 0 != uxAperiodicHeapSize )
+      #else
+        if( 0 != uxDeferredAperiodicJobs )
+      #endif /* POLLING_SERVER_QUEUE_ORDER */
+      {
+        return pdTRUE;
+      }
+      return ( queueHead != queueTail || 0 != uxResumableJobs ) ? pdTRUE : pdFALSE;
+    }
+  #endif /* POLLING_SERVER_MODE */
+
+  #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+    /* Called when a job arrives at the idle CBS. The current deadline and
+     * budget are kept only if the remaining budget c fits the bandwidth Q / T
+     * until that deadline, i.e. c < ( d - now ) * Q / T. Otherwise the server
+     * gets a full budget and a deadline one period from now. */
+    static void prvCBSActivate( SchedTCB_t *pxTCB, TickType_t xTickCount )
+    {
+      TickType_t xRemaining;
+
+      taskENTER_CRITICAL();
+      xRemaining = ( pxTCB->xExecTime < pxTCB->xMaxExecTime ) ? pxTCB->xMaxExecTime - pxTCB->xExecTime : 0;
+      if( ( signed ) ( pxTCB->xAbsoluteDeadline - xTickCount ) <= 0 ||
+          ( unsigned long ) xRemaining * pxTCB->xPeriod >= ( unsigned long ) ( pxTCB->xAbsoluteDeadline - xTickCount ) * pxTCB->xMaxExecTime )
+      {
+        pxTCB->xAbsoluteDeadline = xTickCount + pxTCB->xPeriod;
+        pxTCB->xExecTime = 0;
+      }
+      pxTCB->xWorkIsDone = pdFALSE;
+      taskEXIT_CRITICAL();
+    }
+  #endif /* POLLING_SERVER_MODE */
+#endif /* POLLING_SERVER */
+
+
+/* Returns the extended TCB of the given task, or NULL if the task is not a
+ * periodic task of this library (idle task, scheduler task). Passing NULL
+ * returns the extended TCB of the calling task. Safe to call from the tick hook. */
+static SchedTCB_t *prvGetTCBFromHandle( TaskHandle_t xTaskHandle )
+{
+  return ( SchedTCB_t * ) pvTaskGetThreadLocalStoragePointer( xTaskHandle, schedTHREAD_LOCAL_STORAGE_POINTER_INDEX );
+}
+
+/* Returns the cold part of an extended TCB. */
+static SchedTCBCold_t *prvGetColdTCB( SchedTCB_t *pxTCB )
+{
+  return &xTCBColdArray[ pxTCB - xTCBArray ];
+}
+
+#if( schedUSE_TCB_ARRAY == 1 )
+  /* Initializes xTCBArray. */
+  static void prvInitTCBArray( void )
+  {
+  UBaseType_t uxIndex;
+    for( uxIndex = 0; uxIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; uxIndex++)
+    {
+      xTCBArray[ uxIndex ].xInUse = pdFALSE;
+      #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+        xTCBArray[ uxIndex ].xHeapPosition = -1;
+      #endif /* schedUSE_TIMING_EVENT_HEAP */
+    }
+  }
+
+  /* Find index for an empty entry in xTCBArray. Returns -1 if there is no empty entry. */
+  static BaseType_t prvFindEmptyElementIndexTCB( void )
+  {
+  BaseType_t xIndex;
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    {
+      if( pdFALSE == xTCBArray[ xIndex ].xInUse )
+      {
+        return xIndex;
+      }
+    }
+
+    return -1;
+  }
+
+  /* Remove a pointer to extended TCB from xTCBArray. */
+  static void prvDeleteTCBFromArray( BaseType_t xIndex )
+  {
+    configASSERT( xIndex >= 0 && xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS );
+    configASSERT( pdTRUE == xTCBArray[ xIndex ].xInUse );
+
+    if( pdTRUE == xTCBArray[ xIndex ].xInUse )
+    {
+      #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+        taskENTER_CRITICAL();
+        prvTimingHeapRemove( &xTCBArray[ xIndex ] );
+        taskEXIT_CRITICAL();
+      #endif /* schedUSE_TIMING_EVENT_HEAP */
+      xTCBArray[ xIndex ].xInUse = pdFALSE;
+      xTaskCounter--;
+    }
+  }
+  
+#endif /* schedUSE_TCB_ARRAY */
+
+
+/* The whole function code that is executed by every periodic task.
+ * This function wraps the task code specified by the user. */
+static void prvPeriodicTaskCode( void *pvParameters )
+{
+  SchedTCB_t *pxThisTask = prvGetTCBFromHandle( NULL );
+
+  configASSERT( NULL != pxThisTask );
+
+  if( 0 != pxThisTask->xReleaseTime )
+  {
+    vTaskDelayUntil( &pxThisTask->xLastWakeTime, pxThisTask->xReleaseTime );
+  }
+
+  #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
+    pxThisTask->xExecutedOnce = pdTRUE;
+  #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
+
+  for( ; ; )
+  {   
+    #if( schedUSE_MODE_CHANGE == 1 )
+      /* Every release is a job boundary, where the task leaves the task set
+       * if it is not part of the current mode. */
+      taskENTER_CRITICAL();
+      if( 0 == ( pxThisTask->uxModes & schedMODE( uxCurrentMode ) ) )
+      {
+        pxThisTask->xDormant = pdTRUE;
+      }
+      else
+      {
+        pxThisTask->xWorkIsDone = pdFALSE;
+        #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE != POLLING_SERVER_MODE_SPORADIC )
+          if( pdTRUE == pxThisTask->isPollingServer )
+          {
+            pxThisTask->xMaxExecTime = xModeServerBudget[ uxCurrentMode ];
+          }
+        #endif /* POLLING_SERVER */
+      }
+      taskEXIT_CRITICAL();
+      if( pdTRUE == pxThisTask->xDormant )
+      {
+        prvWaitForMode( pxThisTask );
+        continue;
+      }
+    #endif /* schedUSE_MODE_CHANGE */
+    pxThisTask->xWorkIsDone = pdFALSE;    
+    schedTRACE( schedTRACE_RELEASE, pxThisTask, pxThisTask->xLastWakeTime, pdFALSE );
+    schedTRACE( schedTRACE_START, pxThisTask, xTaskGetTickCount(), pdFALSE );
+
+    pxThisTask->xAbsoluteDeadline = pxThisTask->xLastWakeTime + pxThisTask->xRelativeDeadline;
+    #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+      taskENTER_CRITICAL();
+      prvUpdateTimingEvent( pxThisTask );
+      taskEXIT_CRITICAL();
+    #endif /* schedUSE_TIMING_EVENT_HEAP */
+
+    /* Execute the task function specified by the user. */
+    prvGetColdTCB( pxThisTask )->pvTaskCode( pvParameters );
+    pxThisTask->xWorkIsDone = pdTRUE;
+    #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+      taskENTER_CRITICAL();
+      prvChargeExecTime( pxThisTask, schedREAD_MICROS() );
+      prvGetColdTCB( pxThisTask )->xExecTimeStats.ulLastJobMicros = pxThisTask->ulJobExecMicros;
+      if( pxThisTask->ulJobExecMicros > prvGetColdTCB( pxThisTask )->xExecTimeStats.ulMaxJobMicros )
+      {
+        prvGetColdTCB( pxThisTask )->xExecTimeStats.ulMaxJobMicros = pxThisTask->ulJobExecMicros;
+      }
+      prvResetExecTime( pxThisTask );
+      taskEXIT_CRITICAL();
+    #endif /* schedUSE_SUBTICK_ACCOUNTING */
+    schedTRACE( schedTRACE_FINISH, pxThisTask, xTaskGetTickCount(), pdFALSE );
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      prvOverloadJobDone( pxThisTask );
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+
+    /* The next deadline is pending as soon as this job is done, even if the
+     * task is not scheduled in time to start the next job. */
+    pxThisTask->xAbsoluteDeadline = pxThisTask->xLastWakeTime + pxThisTask->xRelativeDeadline + pxThisTask->xPeriod;
+    pxThisTask->xExecTime = 0;
+    #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+      taskENTER_CRITICAL();
+      prvUpdateTimingEvent( pxThisTask );
+      taskEXIT_CRITICAL();
+    #endif /* schedUSE_TIMING_EVENT_HEAP */
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+      /* Rank the remaining jobs again before blocking. */
+      prvEDFReschedule();
+    #endif /* schedSCHEDULING_POLICY */
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      /* A skipped release can put xLastWakeTime ahead of the tick count,
+       * which vTaskDelayUntil takes for a tick count overflow. Wait for it
+       * first. */
+      TickType_t xTickCount = xTaskGetTickCount();
+      if( ( signed ) ( pxThisTask->xLastWakeTime - xTickCount ) > 0 )
+      {
+        vTaskDelay( pxThisTask->xLastWakeTime - xTickCount );
+      }
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+    vTaskDelayUntil( &pxThisTask->xLastWakeTime, pxThisTask->xPeriod );
+  }
+}
 
 /* Creates a periodic task. */
+BaseType_t xSchedulerPeriodicTaskCreate( TaskFunction_t pvTaskCode, const char *pcName, UBaseType_t uxStackDepth, void *pvParameters, UBaseType_t uxPriority,
+    TaskHandle_t *pxCreatedTask, TickType_t xPhaseTick, TickType_t xPeriodTick, TickType_t xMaxExecTimeTick, TickType_t xDeadlineTick )
+{
+  taskENTER_CRITICAL();
+  
+  SchedTCB_t *pxNewTCB;
+  #if( schedUSE_TCB_ARRAY == 1 )
+    BaseType_t xIndex = prvFindEmptyElementIndexTCB();
+    if( -1 == xIndex )
+    {
+      taskEXIT_CRITICAL();
+      return schedERROR_NO_TCB_SLOT;
+    }
+    pxNewTCB = &xTCBArray[ xIndex ];  
+  #endif /* schedUSE_TCB_ARRAY */
+
+  prvGetColdTCB( pxNewTCB )->pvTaskCode = pvTaskCode;
+  prvGetColdTCB( pxNewTCB )->pcName = pcName;
+  prvGetColdTCB( pxNewTCB )->uxStackDepth = uxStackDepth;
+  prvGetColdTCB( pxNewTCB )->pvParameters = pvParameters;
+  pxNewTCB->uxPriority = uxPriority;
+  pxNewTCB->pxTaskHandle = pxCreatedTask;
+  pxNewTCB->xReleaseTime = xPhaseTick;
+  pxNewTCB->xPeriod = xPeriodTick;
+  pxNewTCB->xMaxExecTime = xMaxExecTimeTick;
+  pxNewTCB->xRelativeDeadline = xDeadlineTick;
+  pxNewTCB->xWorkIsDone = pdTRUE;
+  pxNewTCB->xExecTime = 0;    
+  #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+    prvResetExecTime( pxNewTCB );
+    prvGetColdTCB( pxNewTCB )->xExecTimeStats.ulLastJobMicros = 0;
+    prvGetColdTCB( pxNewTCB )->xExecTimeStats.ulMaxJobMicros = 0;
+  #endif /* schedUSE_SUBTICK_ACCOUNTING */
+  /* The phase of a task that is added at runtime counts from now. */
+  pxNewTCB->xLastWakeTime = ( pdTRUE == xSchedulerStarted ) ? xTaskGetTickCount() : 0;
+  pxNewTCB->xAbsoluteDeadline = pxNewTCB->xLastWakeTime + pxNewTCB->xReleaseTime + pxNewTCB->xRelativeDeadline;
+  
+  #if( schedUSE_TCB_ARRAY == 1 )
+    pxNewTCB->xInUse = pdTRUE;
+  #endif /* schedUSE_TCB_ARRAY */
+  
+  #if( schedFIXED_PRIORITY_POLICY )
+    pxNewTCB->xPriorityIsSet = pdFALSE; 
+  #endif /* schedSCHEDULING_POLICY */
+  
+  #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
+    pxNewTCB->xExecutedOnce = pdFALSE;
+  #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
+  
+  #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
+    pxNewTCB->xSuspended = pdFALSE;
+    pxNewTCB->xMaxExecTimeExceeded = pdFALSE;
+  #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */ 
+
+  #if (POLLING_SERVER == 1)
+    pxNewTCB->isPollingServer = pdFALSE;
+  #endif
+
+  #if( schedUSE_MODE_CHANGE == 1 )
+    pxNewTCB->uxModes = schedALL_MODES;
+    pxNewTCB->xDormant = pdFALSE;
+  #endif /* schedUSE_MODE_CHANGE */
+
+  #if( schedUSE_OVERLOAD_POLICIES == 1 )
+    prvOverloadInit( pxNewTCB );
+  #endif /* schedUSE_OVERLOAD_POLICIES */
+
+  #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+    pxNewTCB->xHeapPosition = -1;
+  #endif /* schedUSE_TIMING_EVENT_HEAP */
+
+  #if( schedUSE_TCB_ARRAY == 1 )
+    xTaskCounter++; 
+  #endif /* schedUSE_TCB_SORTED_LIST */
+  taskEXIT_CRITICAL();  
+
+  /* Before vSchedulerStart, the whole task set is checked and created at once. */
+  if( pdTRUE == xSchedulerStarted )
+  {
+    #if( schedUSE_ADMISSION_CONTROL == 1 )
+      if( schedADMISSION_OK != prvAdmitTaskSet() )
+      {
+        prvDeleteTCBFromArray( xIndex );
+        #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_OPA )
+          /* The admission ranked the set with the new task. */
+          vTaskSuspendAll();
+          prvSetFixedPriorities();
+          ( void ) xTaskResumeAll();
+        #endif /* schedSCHEDULING_POLICY */
+        return schedERROR_NOT_ADMITTED;
+      }
+    #endif /* schedUSE_ADMISSION_CONTROL */
+
+    if( pdPASS != prvStartTaskAtRuntime( pxNewTCB ) )
+    {
+      prvDeleteTCBFromArray( xIndex );
+      return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+    }
+  }
+  return pdPASS;
+}
+
 void vSchedulerPeriodicTaskCreate( TaskFunction_t pvTaskCode, const char *pcName, UBaseType_t uxStackDepth, void *pvParameters, UBaseType_t uxPriority,
     TaskHandle_t *pxCreatedTask, TickType_t xPhaseTick, TickType_t xPeriodTick, TickType_t xMaxExecTimeTick, TickType_t xDeadlineTick )
 {
-  taskENTER_CRITICAL();
-  
-  SchedTCB_t *pxNewTCB;
+  BaseType_t xResult = xSchedulerPeriodicTaskCreate( pvTaskCode, pcName, uxStackDepth, pvParameters, uxPriority, pxCreatedTask,
+                                                     xPhaseTick, xPeriodTick, xMaxExecTimeTick, xDeadlineTick );
+
+  configASSERT( schedERROR_NO_TCB_SLOT != xResult );
+  ( void ) xResult;
+}
+
+/* Ranks the task set again with the new task, and creates the task. The
+ * kernel is suspended, so the new task cannot run before its TLS pointer is
+ * set, and no task runs with a stale priority. */
+static BaseType_t prvStartTaskAtRuntime( SchedTCB_t *pxTCB )
+{
+  BaseType_t xReturnValue;
+
+  vTaskSuspendAll();
+  #if( schedFIXED_PRIORITY_POLICY )
+    prvSetFixedPriorities();
+  #elif( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+    /* Ranked by the scheduler task once the kernel is resumed. */
+    pxTCB->uxPriority = schedEDF_PRIORITY_LOW;
+  #endif /* schedSCHEDULING_POLICY */
+
+  xReturnValue = prvCreateTask( pxTCB );
+  if( pdPASS != xReturnValue )
+  {
+    /* Leave the other tasks as they were. */
+    pxTCB->xInUse = pdFALSE;
+    #if( schedFIXED_PRIORITY_POLICY )
+      prvSetFixedPriorities();
+    #endif /* schedSCHEDULING_POLICY */
+    pxTCB->xInUse = pdTRUE;
+  }
+
+  #if( schedFIXED_PRIORITY_POLICY )
+    prvApplyPriorities();
+  #endif /* schedSCHEDULING_POLICY */
+  ( void ) xTaskResumeAll();
+
+  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+    prvEDFReschedule();
+  #endif /* schedSCHEDULING_POLICY */
+
+  return xReturnValue;
+}
+
+/* Deletes a periodic task. Can be called while the scheduler is running, the
+ * remaining tasks are ranked again and the TCB slot can be reused. */
+void vSchedulerPeriodicTaskDelete( TaskHandle_t xTaskHandle )
+{
+  /* A NULL handle refers to the calling task, same as for the TLS lookup. */
+  SchedTCB_t *pxTCB = prvGetTCBFromHandle( xTaskHandle );
+  BaseType_t xDeleteSelf = ( NULL == xTaskHandle || xTaskGetCurrentTaskHandle() == xTaskHandle ) ? pdTRUE : pdFALSE;
+
+  configASSERT( NULL != pxTCB );
+
+  vTaskSuspendAll();
+  /* The tick hook must not charge the slot once it is reused. */
+  vTaskSetThreadLocalStoragePointer( xTaskHandle, schedTHREAD_LOCAL_STORAGE_POINTER_INDEX, NULL );
   #if( schedUSE_TCB_ARRAY == 1 )
-    BaseType_t xIndex = prvFindEmptyElementIndexTCB();
-    configASSERT( xTaskCounter < schedMAX_NUMBER_OF_PERIODIC_TASKS );
-    configASSERT( xIndex != -1 );
-    pxNewTCB = &xTCBArray[ xIndex ];  
+    prvDeleteTCBFromArray( pxTCB - xTCBArray );
+  #endif /* schedUSE_TCB_ARRAY */
+
+  #if( schedFIXED_PRIORITY_POLICY )
+    if( pdTRUE == xSchedulerStarted )
+    {
+      prvSetFixedPriorities();
+      prvApplyPriorities();
+    }
+  #endif /* schedSCHEDULING_POLICY */
+
+  /* Another task is deleted before it can run again on the freed slot. A
+   * task can only delete itself once the kernel is resumed. */
+  if( pdFALSE == xDeleteSelf )
+  {
+    vTaskDelete( xTaskHandle );
+  }
+  #if( schedUSE_STATIC_ALLOCATION == 1 )
+    else
+    {
+      /* The buffers of a task that deletes itself are in use until the idle
+       * task cleans up, but the slot can be reused right away. The scheduler
+       * task deletes it instead, and runs before any other task once the
+       * kernel is resumed. */
+      xPendingDeleteHandle = xTaskGetCurrentTaskHandle();
+      xTaskNotifyGive( xSchedulerHandle );
+    }
+  #endif /* schedUSE_STATIC_ALLOCATION */
+  ( void ) xTaskResumeAll();
+
+  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+    if( pdTRUE == xSchedulerStarted )
+    {
+      prvEDFReschedule();
+    }
+  #endif /* schedSCHEDULING_POLICY */
+
+  if( pdTRUE == xDeleteSelf )
+  {
+    /* Not reached with schedUSE_STATIC_ALLOCATION. */
+    vTaskDelete( NULL );
+  }
+}
+
+/* Creates the task of a periodic task and stores its extended TCB in the TLS
+ * slot. With schedUSE_STATIC_ALLOCATION, the task uses the buffers of its
+ * TCB slot, which are free as soon as the previous task of the slot has been
+ * deleted by another task. */
+static BaseType_t prvCreateTask( SchedTCB_t *pxTCB )
+{
+  SchedTCBCold_t *pxCold = prvGetColdTCB( pxTCB );
+
+  #if( schedUSE_STATIC_ALLOCATION == 1 )
+    BaseType_t xIndex = pxTCB - xTCBArray;
+
+    configASSERT( pxCold->uxStackDepth <= schedSTATIC_STACK_DEPTH );
+    *pxTCB->pxTaskHandle = xTaskCreateStatic( prvPeriodicTaskCode, pxCold->pcName, schedSTATIC_STACK_DEPTH, pxCold->pvParameters, pxTCB->uxPriority,
+        xTaskStacks[ xIndex ], &xTaskBuffers[ xIndex ] );
+    if( NULL == *pxTCB->pxTaskHandle )
+    {
+      return pdFAIL;
+    }
+  #else
+    if( pdPASS != xTaskCreate( prvPeriodicTaskCode, pxCold->pcName, pxCold->uxStackDepth, pxCold->pvParameters, pxTCB->uxPriority, pxTCB->pxTaskHandle ) )
+    {
+      return pdFAIL;
+    }
+  #endif /* schedUSE_STATIC_ALLOCATION */
+
+  vTaskSetThreadLocalStoragePointer( *pxTCB->pxTaskHandle, schedTHREAD_LOCAL_STORAGE_POINTER_INDEX, pxTCB );
+  return pdPASS;
+}
+
+/* Creates all periodic tasks stored in TCB array, or TCB list. */
+static void prvCreateAllTasks( void )
+{
+  SchedTCB_t *pxTCB;
+
+  #if( schedUSE_TCB_ARRAY == 1 )
+    BaseType_t xIndex;
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    {
+      pxTCB = &xTCBArray[ xIndex ];
+      if( pdFALSE == pxTCB->xInUse )
+      {
+        continue;
+      }
+      pxTCB->xLastWakeTime = xSystemStartTime;
+
+      if( pdPASS != prvCreateTask( pxTCB ) )
+      {
+        /* The scheduler task must not check a task without a handle. */
+        prvDeleteTCBFromArray( xIndex );
+      }
+    } 
   #endif /* schedUSE_TCB_ARRAY */
+}
+
+#if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS || schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
+  /* Initiazes fixed priorities of all periodic tasks with respect to RMS or DMS policy. */
+static void prvSetFixedPriorities( void )
+{
+  BaseType_t xIter, xIndex;
+  TickType_t xShortest, xPreviousShortest=0;
+  SchedTCB_t *pxShortestTaskPointer, *pxTCB;
+  #if( schedUSE_OVERHEAD_STATS == 1 )
+    unsigned long ulOverheadStart = schedREAD_OVERHEAD_CLOCK();
+  #endif /* schedUSE_OVERHEAD_STATS */
+
+  #if( schedUSE_SCHEDULER_TASK == 1 )
+    BaseType_t xHighestPriority = schedSCHEDULER_PRIORITY; 
+  #else
+    BaseType_t xHighestPriority = configMAX_PRIORITIES;
+  #endif /* schedUSE_SCHEDULER_TASK */
+
+  /* Called again whenever the task set changes at runtime. */
+  for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+  {
+    xTCBArray[ xIndex ].xPriorityIsSet = pdFALSE;
+  }
+
+  for( xIter = 0; xIter < xTaskCounter; xIter++ )
+  {
+    xShortest = portMAX_DELAY;
+
+    /* search for shortest period/deadline */
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    {
+      pxTCB = &xTCBArray[ xIndex ];
+      if( pdFALSE == pxTCB->xInUse || pdTRUE == pxTCB->xPriorityIsSet )
+      {
+        continue;
+      }
+
+      #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS )
+        if( pxTCB->xPeriod <= xShortest )
+        {
+          xShortest = pxTCB->xPeriod;
+          pxShortestTaskPointer = pxTCB;
+        }
+      #elif( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
+        if( pxTCB->xRelativeDeadline <= xShortest )
+        {
+          xShortest = pxTCB->xRelativeDeadline;
+          pxShortestTaskPointer = pxTCB;
+        }
+      #endif /* schedSCHEDULING_POLICY */
+    }
+    configASSERT( -1 <= xHighestPriority );
+    if( xPreviousShortest != xShortest )
+    {
+      xHighestPriority--;
+    }
+
+    /* set highest priority to task with xShortest period (the highest priority is configMAX_PRIORITIES-1) */
+    pxShortestTaskPointer->uxPriority = xHighestPriority;
+    pxShortestTaskPointer->xPriorityIsSet = pdTRUE;
+
+    xPreviousShortest = xShortest;    
+  }
+  #if( schedUSE_OVERHEAD_STATS == 1 )
+    prvRecordOverhead( schedOVERHEAD_PRIORITY_ASSIGNMENT, ulOverheadStart );
+  #endif /* schedUSE_OVERHEAD_STATS */
+}
+
+#elif( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_OPA )
+/* Assigns priorities with Audsley's algorithm, from the lowest level up.
+ * Each level goes to a task that meets its deadline there while all tasks
+ * without a level yet have a higher priority. Their relative order does not
+ * change the interference, so the assignment is optimal: it succeeds for
+ * every task set that some fixed-priority order can schedule, including the
+ * polling server, and sets with D > T. Of the tasks that fit, the one with
+ * the longest deadline is taken. If none fits, the set is not schedulable;
+ * the rest is then ranked deadline monotonically, and the admission control
+ * reports the failure. Tasks outside the current mode go to the bottom.
+ * With more tasks than levels between the idle task and the scheduler task,
+ * the first tasks that are placed share the lowest level. The assignment is
+ * not optimal then, and the admission control analyses the shared level
+ * like any other, where tasks of the same priority delay each other. */
+static void prvSetFixedPriorities( void )
+{
+  BaseType_t xIndex, xFits, xChosenFits = pdFALSE;
+  UBaseType_t uxLevel, uxPlaced, uxShared, uxTasks = 0;
+  SchedTCB_t *pxTCB, *pxChosen;
+  #if( schedUSE_OVERHEAD_STATS == 1 )
+    unsigned long ulOverheadStart = schedREAD_OVERHEAD_CLOCK();
+  #endif /* schedUSE_OVERHEAD_STATS */
+
+  #if( schedUSE_SCHEDULER_TASK == 1 )
+    UBaseType_t uxUnassigned = schedSCHEDULER_PRIORITY;
+  #else
+    UBaseType_t uxUnassigned = configMAX_PRIORITIES;
+  #endif /* schedUSE_SCHEDULER_TASK */
+
+  for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+  {
+    pxTCB = &xTCBArray[ xIndex ];
+    pxTCB->xPriorityIsSet = pdFALSE;
+    if( pdTRUE == pxTCB->xInUse )
+    {
+      pxTCB->uxPriority = uxUnassigned;
+      uxTasks++;
+    }
+  }
+  /* Every task gets its own level right below the scheduler task, as long
+   * as there are enough. */
+  configASSERT( uxUnassigned > tskIDLE_PRIORITY + 1 );
+  uxShared = ( uxTasks + tskIDLE_PRIORITY < uxUnassigned ) ? 1 : uxTasks + tskIDLE_PRIORITY + 2 - uxUnassigned;
+
+  for( uxPlaced = 0; uxPlaced < uxTasks; uxPlaced++ )
+  {
+    uxLevel = ( uxPlaced < uxShared ) ? uxUnassigned + uxShared - uxTasks - 1 : uxUnassigned + uxPlaced - uxTasks;
+    pxChosen = NULL;
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    {
+      pxTCB = &xTCBArray[ xIndex ];
+      if( pdFALSE == pxTCB->xInUse || pdTRUE == pxTCB->xPriorityIsSet )
+      {
+        continue;
+      }
+
+      pxTCB->uxPriority = uxLevel;
+      xFits = ( pdFALSE == prvIsAnalysed( pxTCB ) ||
+                prvResponseTime( pxTCB, pxTCB->xRelativeDeadline ) <= pxTCB->xRelativeDeadline ) ? pdTRUE : pdFALSE;
+      pxTCB->uxPriority = uxUnassigned;
+
+      if( NULL == pxChosen || xFits > xChosenFits ||
+          ( xFits == xChosenFits && pxTCB->xRelativeDeadline > pxChosen->xRelativeDeadline ) )
+      {
+        pxChosen = pxTCB;
+        xChosenFits = xFits;
+      }
+    }
+
+    pxChosen->uxPriority = uxLevel;
+    pxChosen->xPriorityIsSet = pdTRUE;
+  }
+  #if( schedUSE_OVERHEAD_STATS == 1 )
+    prvRecordOverhead( schedOVERHEAD_PRIORITY_ASSIGNMENT, ulOverheadStart );
+  #endif /* schedUSE_OVERHEAD_STATS */
+}
+#endif /* schedSCHEDULING_POLICY */
+
+/* Gives the created tasks the priorities stored in their TCBs. Only tasks
+ * whose rank has changed are touched. */
+static void prvApplyPriorities( void )
+{
+  BaseType_t xIndex;
+  SchedTCB_t *pxTCB;
+
+  for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+  {
+    pxTCB = &xTCBArray[ xIndex ];
+    if( pdTRUE == pxTCB->xInUse && NULL != *pxTCB->pxTaskHandle &&
+        uxTaskPriorityGet( *pxTCB->pxTaskHandle ) != pxTCB->uxPriority )
+    {
+      vTaskPrioritySet( *pxTCB->pxTaskHandle, pxTCB->uxPriority );
+    }
+  }
+}
+
+
+#if( schedUSE_MODE_CHANGE == 1 || schedUSE_OVERLOAD_POLICIES == 1 )
+  /* Returns the TCB that was created with the task handle pointer
+   * pxCreatedTask, or NULL. Works before the task itself is created. */
+  static SchedTCB_t *prvFindTCBByHandlePointer( TaskHandle_t *pxCreatedTask )
+  {
+    BaseType_t xIndex;
+
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    {
+      if( pdTRUE == xTCBArray[ xIndex ].xInUse && pxCreatedTask == xTCBArray[ xIndex ].pxTaskHandle )
+      {
+        return &xTCBArray[ xIndex ];
+      }
+    }
+    return NULL;
+  }
+#endif /* schedUSE_MODE_CHANGE || schedUSE_OVERLOAD_POLICIES */
+
+
+#if( schedUSE_MODE_CHANGE == 1 )
+  /* Blocks the calling task until a mode change lets it join again, and then
+   * until the release time of that mode change. */
+  static void prvWaitForMode( SchedTCB_t *pxTCB )
+  {
+    TickType_t xTickCount;
+
+    #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+      taskENTER_CRITICAL();
+      prvUpdateTimingEvent( pxTCB );
+      taskEXIT_CRITICAL();
+    #endif /* schedUSE_TIMING_EVENT_HEAP */
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+      prvEDFReschedule();
+    #endif /* schedSCHEDULING_POLICY */
+
+    ulTaskNotifyTakeIndexed( schedMODE_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+
+    xTickCount = xTaskGetTickCount();
+    pxTCB->xLastWakeTime = xTickCount;
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+      /* Rejoin the deadline ranking now, so the release is seen by the tick hook. */
+      pxTCB->xAbsoluteDeadline = ( ( ( signed ) ( xModeReleaseTime - xTickCount ) > 0 ) ? xModeReleaseTime : xTickCount ) + pxTCB->xRelativeDeadline;
+      pxTCB->xDormant = pdFALSE;
+      prvEDFReschedule();
+    #endif /* schedSCHEDULING_POLICY */
+    if( ( signed ) ( xModeReleaseTime - xTickCount ) > 0 )
+    {
+      vTaskDelayUntil( &pxTCB->xLastWakeTime, xModeReleaseTime - xTickCount );
+    }
+    pxTCB->xExecTime = 0;
+    #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+      taskENTER_CRITICAL();
+      prvResetExecTime( pxTCB );
+      taskEXIT_CRITICAL();
+    #endif /* schedUSE_SUBTICK_ACCOUNTING */
+    pxTCB->xDormant = pdFALSE;
+  }
+
+  void vSchedulerPeriodicTaskSetModes( TaskHandle_t *pxCreatedTask, UBaseType_t uxModes )
+  {
+    SchedTCB_t *pxTCB;
+
+    taskENTER_CRITICAL();
+    pxTCB = prvFindTCBByHandlePointer( pxCreatedTask );
+    configASSERT( NULL != pxTCB );
+    if( NULL != pxTCB )
+    {
+      /* Takes effect at the next release of the task. */
+      pxTCB->uxModes = uxModes;
+    }
+    taskEXIT_CRITICAL();
+  }
+
+  void vSchedulerSetModeServerBudget( UBaseType_t uxMode, TickType_t xBudget )
+  {
+    configASSERT( uxMode < schedMAX_NUMBER_OF_MODES );
+    #if( POLLING_SERVER == 1 )
+      taskENTER_CRITICAL();
+      xModeServerBudget[ uxMode ] = xBudget;
+      taskEXIT_CRITICAL();
+    #endif /* POLLING_SERVER */
+  }
+
+  BaseType_t xSchedulerRequestModeChange( UBaseType_t uxMode )
+  {
+    BaseType_t xIndex;
+    SchedTCB_t *pxTCB;
+    TickType_t xReleaseTime;
+
+    if( uxMode >= schedMAX_NUMBER_OF_MODES )
+    {
+      return pdFAIL;
+    }
+
+    vTaskSuspendAll();
+    #if( schedUSE_ADMISSION_CONTROL == 1 )
+      UBaseType_t uxOldMode = uxCurrentMode;
+    #endif /* schedUSE_ADMISSION_CONTROL */
+    uxCurrentMode = uxMode;
+
+    #if( schedUSE_ADMISSION_CONTROL == 1 )
+      if( schedADMISSION_OK != prvAdmitTaskSet() )
+      {
+        uxCurrentMode = uxOldMode;
+        #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_OPA )
+          prvSetFixedPriorities();
+        #endif /* schedSCHEDULING_POLICY */
+        ( void ) xTaskResumeAll();
+        return pdFAIL;
+      }
+    #endif /* schedUSE_ADMISSION_CONTROL */
+
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_OPA )
+      /* The optimal order depends on the task set of the mode. */
+      prvSetFixedPriorities();
+      prvApplyPriorities();
+    #endif /* schedSCHEDULING_POLICY */
+
+    /* Tasks that leave in the middle of a job may use the processor until
+     * the deadline of that job. Joining tasks are released after it. */
+    xReleaseTime = xTaskGetTickCount();
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    {
+      pxTCB = &xTCBArray[ xIndex ];
+      if( pdTRUE == pxTCB->xInUse && pdFALSE == pxTCB->xDormant && pdFALSE == pxTCB->xWorkIsDone &&
+          0 == ( pxTCB->uxModes & schedMODE( uxMode ) ) &&
+          ( signed ) ( pxTCB->xAbsoluteDeadline - xReleaseTime ) > 0 )
+      {
+        xReleaseTime = pxTCB->xAbsoluteDeadline;
+      }
+    }
+    xModeReleaseTime = xReleaseTime;
 
-  pxNewTCB->pvTaskCode = pvTaskCode;
-  pxNewTCB->pcName = pcName;
-  pxNewTCB->uxStackDepth = uxStackDepth;
-  pxNewTCB->pvParameters = pvParameters;
-  pxNewTCB->uxPriority = uxPriority;
-  pxNewTCB->pxTaskHandle = pxCreatedTask;
-  pxNewTCB->xReleaseTime = xPhaseTick;
-  pxNewTCB->xPeriod = xPeriodTick;
-  pxNewTCB->xMaxExecTime = xMaxExecTimeTick;
-  pxNewTCB->xRelativeDeadline = xDeadlineTick;
-  pxNewTCB->xAbsoluteDeadline = pxNewTCB->xRelativeDeadline + pxNewTCB->xReleaseTime;    
-  pxNewTCB->xWorkIsDone = pdTRUE;
-  pxNewTCB->xExecTime = 0;    
-  
-  #if( schedUSE_TCB_ARRAY == 1 )
-    pxNewTCB->xInUse = pdTRUE;
-  #endif /* schedUSE_TCB_ARRAY */
-  
-  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS || schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
-    pxNewTCB->xPriorityIsSet = pdFALSE; 
-  #endif /* schedSCHEDULING_POLICY */
-  
-  #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
-    pxNewTCB->xExecutedOnce = pdFALSE;
-  #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
-  
-  #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
-    pxNewTCB->xSuspended = pdFALSE;
-    pxNewTCB->xMaxExecTimeExceeded = pdFALSE;
-  #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */ 
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+    {
+      pxTCB = &xTCBArray[ xIndex ];
+      if( pdTRUE == pxTCB->xInUse && pdTRUE == pxTCB->xDormant &&
+          0 != ( pxTCB->uxModes & schedMODE( uxMode ) ) )
+      {
+        xTaskNotifyGiveIndexed( *pxTCB->pxTaskHandle, schedMODE_NOTIFICATION_INDEX );
+      }
+    }
 
-  #if (POLLING_SERVER == 1)
-    pxNewTCB->isPollingServer = pdFALSE;
-  #endif
+    #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+      /* The sporadic server has no period boundary, its budget changes now. */
+      if( NULL != pxSporadicServerTCB )
+      {
+        taskENTER_CRITICAL();
+        pxSporadicServerTCB->xMaxExecTime = xModeServerBudget[ uxMode ];
+        taskEXIT_CRITICAL();
+      }
+    #elif( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+      /* Neither has the CBS. */
+      if( NULL != pollingSeverTaskHandle )
+      {
+        pxTCB = prvGetTCBFromHandle( pollingSeverTaskHandle );
+        taskENTER_CRITICAL();
+        pxTCB->xMaxExecTime = xModeServerBudget[ uxMode ];
+        taskEXIT_CRITICAL();
+      }
+    #endif /* POLLING_SERVER_MODE */
+    ( void ) xTaskResumeAll();
 
-  #if( schedUSE_TCB_ARRAY == 1 )
-    xTaskCounter++; 
-  #endif /* schedUSE_TCB_SORTED_LIST */
-  taskEXIT_CRITICAL();  
-}
+    return pdPASS;
+  }
 
-/* Deletes a periodic task. */
-void vSchedulerPeriodicTaskDelete( TaskHandle_t xTaskHandle )
-{
-  if( xTaskHandle != NULL )
+  UBaseType_t uxSchedulerGetMode( void )
   {
-    #if( schedUSE_TCB_ARRAY == 1 )
-      prvDeleteTCBFromArray( prvGetTCBIndexFromHandle( xTaskHandle ) );   
-    #endif /* schedUSE_TCB_ARRAY */
+    return uxCurrentMode;
   }
-  else
+#endif /* schedUSE_MODE_CHANGE */
+
+
+#if( schedUSE_ADMISSION_CONTROL == 1 || schedUSE_RESPONSE_TIME_ANALYSIS )
+  /* pdTRUE if the task is part of the task set that is analysed, which is the
+   * set of the current mode. */
+  static BaseType_t prvIsAnalysed( SchedTCB_t *pxTCB )
   {
-    #if( schedUSE_TCB_ARRAY == 1 )
-      prvDeleteTCBFromArray( prvGetTCBIndexFromHandle( xTaskGetCurrentTaskHandle() ) );   
-    #endif /* schedUSE_TCB_ARRAY */
+    #if( schedUSE_MODE_CHANGE == 1 )
+      if( 0 == ( pxTCB->uxModes & schedMODE( uxCurrentMode ) ) )
+      {
+        return pdFALSE;
+      }
+    #endif /* schedUSE_MODE_CHANGE */
+    return pxTCB->xInUse;
   }
-  
-  vTaskDelete( xTaskHandle );
-}
 
-/* Creates all periodic tasks stored in TCB array, or TCB list. */
-static void prvCreateAllTasks( void )
-{
-  SchedTCB_t *pxTCB;
+  /* Worst-case execution time of the task in the analysed mode. */
+  static TickType_t prvAnalysedExecTime( SchedTCB_t *pxTCB )
+  {
+    #if( schedUSE_MODE_CHANGE == 1 && POLLING_SERVER == 1 )
+      if( pdTRUE == pxTCB->isPollingServer )
+      {
+        return xModeServerBudget[ uxCurrentMode ];
+      }
+    #endif /* schedUSE_MODE_CHANGE */
+    return pxTCB->xMaxExecTime;
+  }
+#endif /* schedUSE_ADMISSION_CONTROL || schedUSE_RESPONSE_TIME_ANALYSIS */
 
-  #if( schedUSE_TCB_ARRAY == 1 )
+
+#if( schedUSE_RESPONSE_TIME_ANALYSIS )
+  /* pdTRUE if pxOtherTCB can delay pxTCB, i.e. it gets the same or a higher
+   * priority under the scheduling policy. Ties are counted as interference. */
+  static BaseType_t prvHasPriorityOver( SchedTCB_t *pxOtherTCB, SchedTCB_t *pxTCB )
+  {
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS )
+      return ( pxOtherTCB->xPeriod <= pxTCB->xPeriod ) ? pdTRUE : pdFALSE;
+    #elif( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
+      return ( pxOtherTCB->xRelativeDeadline <= pxTCB->xRelativeDeadline ) ? pdTRUE : pdFALSE;
+    #else
+      return ( pxOtherTCB->uxPriority >= pxTCB->uxPriority ) ? pdTRUE : pdFALSE;
+    #endif /* schedSCHEDULING_POLICY */
+  }
+
+  /* Worst-case execution time that the higher priority task pxTCB can take
+   * within a window of ulWindow ticks. */
+  static unsigned long prvInterference( SchedTCB_t *pxTCB, unsigned long ulWindow )
+  {
+    unsigned long ulJitter = 0;
+
+    #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_DEFERRABLE )
+      /* A deferrable server can use its budget at the end of one period and
+       * again at the start of the next, which is a release jitter of T - C. */
+      if( pdTRUE == pxTCB->isPollingServer )
+      {
+        ulJitter = pxTCB->xPeriod - prvAnalysedExecTime( pxTCB );
+      }
+    #endif /* POLLING_SERVER_MODE */
+
+    return ( ( ulWindow + ulJitter + pxTCB->xPeriod - 1 ) / pxTCB->xPeriod ) * prvAnalysedExecTime( pxTCB );
+  }
+
+  /* Computes the worst-case response time of the task for any deadline. The
+   * jobs of a task run one after the other, so with D > T a job can also be
+   * delayed by the previous jobs of the same task. Job q of the busy period
+   * ends at w = q * C + sum( ceil( w / Tj ) * Cj ) over the tasks that can
+   * delay it, and the busy period ends with the first job that ends before
+   * the next release. The polling server is a periodic task with its budget
+   * as execution time. Stops as soon as a response exceeds ulLimit, and
+   * returns that response. */
+  static unsigned long prvResponseTime( SchedTCB_t *pxTCB, unsigned long ulLimit )
+  {
     BaseType_t xIndex;
-    for( xIndex = 0; xIndex < xTaskCounter; xIndex++ )
-    {
-      configASSERT( pdTRUE == xTCBArray[ xIndex ].xInUse );
-      pxTCB = &xTCBArray[ xIndex ];
+    SchedTCB_t *pxOtherTCB;
+    unsigned long ulJobs, ulWindow, ulPrevious, ulJobResponse, ulResponse = 0;
 
-      BaseType_t xReturnValue = xTaskCreate( prvPeriodicTaskCode, pxTCB->pcName, pxTCB->uxStackDepth, pxTCB->pvParameters, pxTCB->uxPriority, pxTCB->pxTaskHandle);         
-    } 
-  #endif /* schedUSE_TCB_ARRAY */
-}
+    for( ulJobs = 1; ; ulJobs++ )
+    {
+      ulWindow = ulJobs * prvAnalysedExecTime( pxTCB );
+      ulPrevious = 0;
+      while( ulWindow != ulPrevious )
+      {
+        ulPrevious = ulWindow;
+        ulWindow = ulJobs * prvAnalysedExecTime( pxTCB );
+        for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+        {
+          pxOtherTCB = &xTCBArray[ xIndex ];
+          if( pxOtherTCB != pxTCB && pdTRUE == prvIsAnalysed( pxOtherTCB ) && pdTRUE == prvHasPriorityOver( pxOtherTCB, pxTCB ) )
+          {
+            ulWindow += prvInterference( pxOtherTCB, ulPrevious );
+          }
+        }
+        /* The window only grows, so this job is late for sure. */
+        if( ulWindow - ( ulJobs - 1 ) * pxTCB->xPeriod > ulLimit )
+        {
+          return ulWindow - ( ulJobs - 1 ) * pxTCB->xPeriod;
+        }
+      }
 
-#if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS || schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
-  /* Initiazes fixed priorities of all periodic tasks with respect to RMS policy. */
-static void prvSetFixedPriorities( void )
-{
-  BaseType_t xIter, xIndex;
-  TickType_t xShortest, xPreviousShortest=0;
-  SchedTCB_t *pxShortestTaskPointer, *pxTCB;
+      ulJobResponse = ulWindow - ( ulJobs - 1 ) * pxTCB->xPeriod;
+      if( ulJobResponse > ulResponse )
+      {
+        ulResponse = ulJobResponse;
+      }
+      if( ulWindow <= ulJobs * pxTCB->xPeriod )
+      {
+        return ulResponse;
+      }
+    }
+  }
+#endif /* schedUSE_RESPONSE_TIME_ANALYSIS */
 
-  #if( schedUSE_SCHEDULER_TASK == 1 )
-    BaseType_t xHighestPriority = schedSCHEDULER_PRIORITY; 
-  #else
-    BaseType_t xHighestPriority = configMAX_PRIORITIES;
-  #endif /* schedUSE_SCHEDULER_TASK */
 
-  for( xIter = 0; xIter < xTaskCounter; xIter++ )
+#if( schedUSE_ADMISSION_CONTROL == 1 )
+  /* Computes the worst-case response time of every task with
+   * prvResponseTime, and fails a task whose response time exceeds its
+   * deadline. Under EDF, the set passes if its density
+   * sum( C / min( D, T ) ) is at most 100 %. Returns schedADMISSION_OK, or
+   * the reason of the first failure, with the failed task in *ppxFailedTCB. */
+  static BaseType_t prvAnalyseTaskSet( SchedTCB_t **ppxFailedTCB )
   {
-    xShortest = portMAX_DELAY;
+    BaseType_t xIndex, xResult = schedADMISSION_OK;
+    SchedTCB_t *pxTCB;
+    unsigned long ulUtilization = 0;
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+      unsigned long ulBound;
+    #else
+      unsigned long ulResponse;
+    #endif /* schedSCHEDULING_POLICY */
 
-    /* search for shortest period/deadline */
-    for( xIndex = 0; xIndex < xTaskCounter; xIndex++ )
+    *ppxFailedTCB = NULL;
+
+    /* Rounded down, so a sum above 100 % is an overload for sure. */
+    for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
     {
       pxTCB = &xTCBArray[ xIndex ];
-      configASSERT( pdTRUE == pxTCB->xInUse );
-      if(pdTRUE == pxTCB->xPriorityIsSet)
+      if( pdTRUE == prvIsAnalysed( pxTCB ) )
       {
-        continue;
+        configASSERT( 0 != pxTCB->xPeriod );
+        ulUtilization += ( ( unsigned long ) prvAnalysedExecTime( pxTCB ) * 1000UL ) / pxTCB->xPeriod;
       }
+    }
+    if( ulUtilization > 1000UL )
+    {
+      xResult = schedADMISSION_OVERLOAD;
+    }
 
-      #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS )
-        if( pxTCB->xPeriod <= xShortest )
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+      /* Rounded up, so the test stays sufficient. It is exact for D >= T,
+       * and the CBS is a task with budget Q and deadline T. */
+      ulUtilization = 0;
+      for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+      {
+        pxTCB = &xTCBArray[ xIndex ];
+        if( pdTRUE == prvIsAnalysed( pxTCB ) )
         {
-          xShortest = pxTCB->xPeriod;
-          pxShortestTaskPointer = pxTCB;
+          ulBound = ( pxTCB->xRelativeDeadline < pxTCB->xPeriod ) ? pxTCB->xRelativeDeadline : pxTCB->xPeriod;
+          configASSERT( 0 != ulBound );
+          ulUtilization += ( ( unsigned long ) prvAnalysedExecTime( pxTCB ) * 1000UL + ulBound - 1 ) / ulBound;
+          pxTCB->xWorstCaseResponseTime = ( TickType_t ) ulBound;
         }
-      #elif( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
-        if( pxTCB->xRelativeDeadline <= xShortest )
+      }
+      if( ulUtilization > 1000UL && schedADMISSION_OK == xResult )
+      {
+        xResult = schedADMISSION_DEADLINE;
+      }
+    #else
+      for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+      {
+        pxTCB = &xTCBArray[ xIndex ];
+        if( pdFALSE == prvIsAnalysed( pxTCB ) )
         {
-          xShortest = pxTCB->xRelativeDeadline;
-          pxShortestTaskPointer = pxTCB;
+          continue;
         }
-      #endif /* schedSCHEDULING_POLICY */
+
+        /* The analysis stops once the deadline is exceeded, the value is a lower bound then. */
+        ulResponse = prvResponseTime( pxTCB, pxTCB->xRelativeDeadline );
+        pxTCB->xWorstCaseResponseTime = ( ulResponse < portMAX_DELAY ) ? ( TickType_t ) ulResponse : portMAX_DELAY;
+        if( ulResponse > pxTCB->xRelativeDeadline && schedADMISSION_OK == xResult )
+        {
+          xResult = schedADMISSION_DEADLINE;
+          *ppxFailedTCB = pxTCB;
+        }
+      }
+    #endif /* schedSCHEDULING_POLICY */
+
+    return xResult;
+  }
+
+  /* Runs the analysis and records and logs its result. */
+  static BaseType_t prvAdmitTaskSet( void )
+  {
+    SchedTCB_t *pxFailedTCB;
+    BaseType_t xResult;
+
+    vTaskSuspendAll();
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_OPA )
+      /* The analysis needs the priorities, which depend on the task set. */
+      prvSetFixedPriorities();
+    #endif /* schedSCHEDULING_POLICY */
+    xResult = prvAnalyseTaskSet( &pxFailedTCB );
+    xAdmissionResult = xResult;
+    pcAdmissionFailedTask = ( NULL == pxFailedTCB ) ? NULL : prvGetColdTCB( pxFailedTCB )->pcName;
+    ( void ) xTaskResumeAll();
+
+    if( schedADMISSION_OVERLOAD == xResult )
+    {
+      prvLogEvent( schedLOG_TASK_SET_OVERLOADED, NULL, "" );
     }
-    configASSERT( -1 <= xHighestPriority );
-    if( xPreviousShortest != xShortest )
+    else if( schedADMISSION_DEADLINE == xResult )
     {
-      xHighestPriority--;
+      /* The EDF density test fails for the set as a whole, not for a task. */
+      prvLogEvent( schedLOG_TASK_REJECTED, pxFailedTCB, "Set" );
     }
+    return xResult;
+  }
 
-    /* set highest priority to task with xShortest period (the highest priority is configMAX_PRIORITIES-1) */
-    pxShortestTaskPointer->uxPriority = xHighestPriority;
-    pxShortestTaskPointer->xPriorityIsSet = pdTRUE;
+  TickType_t xSchedulerGetWorstCaseResponseTime( TaskHandle_t xTaskHandle )
+  {
+    SchedTCB_t *pxTCB = prvGetTCBFromHandle( xTaskHandle );
 
-    xPreviousShortest = xShortest;    
+    return ( NULL == pxTCB ) ? 0 : pxTCB->xWorstCaseResponseTime;
   }
-}
-#endif /* schedSCHEDULING_POLICY */
+
+  BaseType_t xSchedulerGetAdmissionResult( const char **ppcTaskName )
+  {
+    if( NULL != ppcTaskName )
+    {
+      *ppcTaskName = pcAdmissionFailedTask;
+    }
+    return xAdmissionResult;
+  }
+#endif /* schedUSE_ADMISSION_CONTROL */
 
 
 #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
@@ -460,7 +2377,10 @@ static void prvSetFixedPriorities( void )
   /* Recreates a deleted task that still has its information left in the task array (or list). */
   static void prvPeriodicTaskRecreate( SchedTCB_t *pxTCB )
   {
-    BaseType_t xReturnValue = xTaskCreate( prvPeriodicTaskCode, pxTCB->pcName, pxTCB->uxStackDepth, pxTCB->pvParameters, pxTCB->uxPriority, pxTCB->pxTaskHandle);                             
+    /* The TLS pointer is set before the new task runs; the scheduler task has
+     * the highest priority. With schedUSE_STATIC_ALLOCATION, the task is
+     * recreated in the buffers of the deleted one, which takes bounded time. */
+    BaseType_t xReturnValue = prvCreateTask( pxTCB );
     
     if( pdPASS == xReturnValue )
     { 
@@ -470,18 +2390,37 @@ static void prvSetFixedPriorities( void )
         pxTCB->xSuspended = pdFALSE;
         pxTCB->xMaxExecTimeExceeded = pdFALSE;
       #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
-      
+      #if( schedUSE_OVERLOAD_POLICIES == 1 )
+        pxTCB->xMissHandled = pdFALSE;
+        pxTCB->xOverrunHandled = pdFALSE;
+        pxTCB->xAbortJob = pdFALSE;
+      #endif /* schedUSE_OVERLOAD_POLICIES */
     }   
+    else
+    {
+      /* Out of heap, the task is gone and so is its slot. */
+      prvDeleteTCBFromArray( pxTCB - xTCBArray );
+    }
   }
 
-  /* Called when a deadline of a periodic task is missed.
-   * Deletes the periodic task that has missed it's deadline and recreate it.
-   * The periodic task is released during next period. */
-  static void prvDeadlineMissedHook( SchedTCB_t *pxTCB, TickType_t xTickCount )
-  {    
+  /* Aborts the current job of a periodic task by deleting the task and
+   * recreating it. The periodic task is released during next period. */
+  static void prvAbortJob( SchedTCB_t *pxTCB )
+  {
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      prvGetColdTCB( pxTCB )->xOverloadStats.ulAborted++;
+      if( schedOVERLOAD_FIRM == prvGetColdTCB( pxTCB )->uxOverloadPolicy )
+      {
+        prvFirmRecordMiss( pxTCB );
+      }
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+
     /* Delete the pxTask and recreate it. */
     vTaskDelete( *pxTCB->pxTaskHandle );
     pxTCB->xExecTime = 0;
+    #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+      prvResetExecTime( pxTCB );
+    #endif /* schedUSE_SUBTICK_ACCOUNTING */
     prvPeriodicTaskRecreate( pxTCB );
 
     pxTCB->xReleaseTime = pxTCB->xLastWakeTime + pxTCB->xPeriod;
@@ -490,6 +2429,22 @@ static void prvSetFixedPriorities( void )
     pxTCB->xAbsoluteDeadline = pxTCB->xRelativeDeadline + pxTCB->xReleaseTime;    
   }
 
+  /* Called when a deadline of a periodic task is missed. The job is aborted,
+   * unless the overload policy of the task lets it run on. */
+  static void prvDeadlineMissedHook( SchedTCB_t *pxTCB, TickType_t xTickCount )
+  {
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      prvGetColdTCB( pxTCB )->xOverloadStats.ulMissed++;
+      if( schedOVERLOAD_CONTINUE == prvGetColdTCB( pxTCB )->uxOverloadPolicy || schedOVERLOAD_SKIP_NEXT == prvGetColdTCB( pxTCB )->uxOverloadPolicy )
+      {
+        /* Reported once, the job is counted as late when it completes. */
+        pxTCB->xMissHandled = pdTRUE;
+        return;
+      }
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+    prvAbortJob( pxTCB );
+  }
+
   /* Checks whether given task has missed deadline or not. */
   static void prvCheckDeadline( SchedTCB_t *pxTCB, TickType_t xTickCount )
   {    
@@ -500,13 +2455,16 @@ static void prvSetFixedPriorities( void )
       Serial.end();*/
     if( ( NULL != pxTCB ) && ( pdFALSE == pxTCB->xWorkIsDone ) && ( pdTRUE == pxTCB->xExecutedOnce ) )
     {
+      #if( schedUSE_OVERLOAD_POLICIES == 1 )
+        if( pdTRUE == pxTCB->xMissHandled )
+        {
+          return;
+        }
+      #endif /* schedUSE_OVERLOAD_POLICIES */
       if( ( signed ) ( pxTCB->xAbsoluteDeadline - xTickCount ) < 0 )
       {
-        Serial.begin(9600);
-        Serial.print("Missed Deadline ");
-        Serial.println(pxTCB->pcName);
-        Serial.end();
-        /* Serial.println(pxTCB->pcName);*/
+        prvLogEvent( schedLOG_DEADLINE_MISSED, pxTCB, NULL );
+        schedTRACE( schedTRACE_DEADLINE_MISSED, pxTCB, xTickCount, pdFALSE );
         /* Deadline is missed. */
         prvDeadlineMissedHook( pxTCB, xTickCount );
       }
@@ -515,24 +2473,203 @@ static void prvSetFixedPriorities( void )
 #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
 
 
+#if( schedUSE_OVERLOAD_POLICIES == 1 )
+  /* Gives a new TCB the default overload policy and clears its counters. */
+  static void prvOverloadInit( SchedTCB_t *pxTCB )
+  {
+    static const SchedOverloadStats_t xNoStats = { 0 };
+    SchedTCBCold_t *pxCold = prvGetColdTCB( pxTCB );
+
+    pxCold->uxOverloadPolicy = schedOVERLOAD_RECREATE;
+    pxCold->uxFirmM = 1;
+    pxCold->uxFirmK = 1;
+    pxCold->usFirmHistory = 0xFFFF;
+    pxTCB->xMissHandled = pdFALSE;
+    pxTCB->xOverrunHandled = pdFALSE;
+    pxTCB->xAbortJob = pdFALSE;
+    pxCold->xOverloadStats = xNoStats;
+  }
+
+  /* Returns how many of the last uxK jobs in usHistory met their deadline. */
+  static UBaseType_t prvFirmMetCount( uint16_t usHistory, UBaseType_t uxK )
+  {
+    UBaseType_t uxCount = 0;
+
+    if( uxK < schedOVERLOAD_FIRM_MAX_K )
+    {
+      usHistory &= ( uint16_t ) ( ( 1U << uxK ) - 1U );
+    }
+    for( ; 0 != usHistory; usHistory &= ( uint16_t ) ( usHistory - 1U ) )
+    {
+      uxCount++;
+    }
+    return uxCount;
+  }
+
+  /* Records a job that did not meet its deadline in the (m,k) history, and
+   * reports it if the constraint is broken. */
+  static void prvFirmRecordMiss( SchedTCB_t *pxTCB )
+  {
+    SchedTCBCold_t *pxCold = prvGetColdTCB( pxTCB );
+
+    pxCold->usFirmHistory = ( uint16_t ) ( pxCold->usFirmHistory << 1 );
+    if( prvFirmMetCount( pxCold->usFirmHistory, pxCold->uxFirmK ) < pxCold->uxFirmM )
+    {
+      pxCold->xOverloadStats.ulFirmViolations++;
+      prvLogEvent( schedLOG_FIRM_VIOLATED, pxTCB, NULL );
+    }
+  }
+
+  /* Called by a periodic task when its job completes, before the next
+   * deadline is set. Applies the overload policy to a job that was let run
+   * on, and clears the job state. */
+  static void prvOverloadJobDone( SchedTCB_t *pxTCB )
+  {
+    SchedTCBCold_t *pxCold = prvGetColdTCB( pxTCB );
+    TickType_t xTickCount;
+
+    taskENTER_CRITICAL();
+    xTickCount = xTaskGetTickCount();
+    pxCold->xOverloadStats.ulCompleted++;
+    if( pdTRUE == pxTCB->xMissHandled )
+    {
+      pxCold->xOverloadStats.ulLate++;
+    }
+    if( schedOVERLOAD_SKIP_NEXT == pxCold->uxOverloadPolicy &&
+        ( pdTRUE == pxTCB->xMissHandled || pdTRUE == pxTCB->xOverrunHandled ) )
+    {
+      /* The next job is released one period after xLastWakeTime. Skip until
+       * that release is not in the past. */
+      do
+      {
+        pxTCB->xLastWakeTime += pxTCB->xPeriod;
+        pxCold->xOverloadStats.ulSkipped++;
+      } while( ( signed ) ( pxTCB->xLastWakeTime + pxTCB->xPeriod - xTickCount ) < 0 );
+    }
+    if( schedOVERLOAD_FIRM == pxCold->uxOverloadPolicy )
+    {
+      /* A late job is aborted, so a completed one met its deadline. */
+      pxCold->usFirmHistory = ( uint16_t ) ( ( pxCold->usFirmHistory << 1 ) | 1U );
+    }
+    pxTCB->xMissHandled = pdFALSE;
+    pxTCB->xOverrunHandled = pdFALSE;
+    taskEXIT_CRITICAL();
+  }
+
+  void vSchedulerPeriodicTaskSetOverloadPolicy( TaskHandle_t *pxCreatedTask, UBaseType_t uxPolicy, UBaseType_t uxM, UBaseType_t uxK )
+  {
+    SchedTCB_t *pxTCB;
+
+    configASSERT( uxPolicy <= schedOVERLOAD_ABORT_JOB );
+    configASSERT( schedOVERLOAD_FIRM != uxPolicy || ( 0 < uxM && uxM <= uxK && uxK <= schedOVERLOAD_FIRM_MAX_K ) );
+
+    taskENTER_CRITICAL();
+    pxTCB = prvFindTCBByHandlePointer( pxCreatedTask );
+    configASSERT( NULL != pxTCB );
+    if( NULL != pxTCB )
+    {
+      /* A job that was already let run on completes under the old policy. */
+      prvGetColdTCB( pxTCB )->uxOverloadPolicy = uxPolicy;
+      prvGetColdTCB( pxTCB )->uxFirmM = uxM;
+      prvGetColdTCB( pxTCB )->uxFirmK = uxK;
+      prvGetColdTCB( pxTCB )->usFirmHistory = 0xFFFF;
+    }
+    taskEXIT_CRITICAL();
+  }
+
+  void vSchedulerGetOverloadStats( TaskHandle_t xTaskHandle, SchedOverloadStats_t *pxStats )
+  {
+    SchedTCB_t *pxTCB = prvGetTCBFromHandle( xTaskHandle );
+
+    configASSERT( NULL != pxTCB );
+    if( NULL != pxTCB )
+    {
+      taskENTER_CRITICAL();
+      *pxStats = prvGetColdTCB( pxTCB )->xOverloadStats;
+      taskEXIT_CRITICAL();
+    }
+  }
+#endif /* schedUSE_OVERLOAD_POLICIES */
+
+
 #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
 
   /* Called if a periodic task has exceeded it's worst-case execution time.
-   * The periodic task is blocked until next period. A context switch to
-   * the scheduler task occur to block the periodic task. */
+   * The periodic task is blocked until next period, or handled as its
+   * overload policy says. A context switch to the scheduler task occur to
+   * block the periodic task. */
   static void prvExecTimeExceedHook( TickType_t xTickCount, SchedTCB_t *pxCurrentTask )
   {
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      if( pdTRUE == pxCurrentTask->xOverrunHandled )
+      {
+        /* The job was let run on, an overrun is counted once per job. */
+        return;
+      }
+      SchedTCBCold_t *pxCold = prvGetColdTCB( pxCurrentTask );
+
+      pxCold->xOverloadStats.ulOverruns++;
+      switch( pxCold->uxOverloadPolicy )
+      {
+        case schedOVERLOAD_FIRM:
+          if( prvFirmMetCount( ( uint16_t ) ( pxCold->usFirmHistory << 1 ), pxCold->uxFirmK ) >= pxCold->uxFirmM )
+          {
+            /* The constraint allows one more miss, drop the job. */
+            pxCurrentTask->xAbortJob = pdTRUE;
+            break;
+          }
+          /* The constraint needs this job, let it run on. */
+          /* fall through */
+        case schedOVERLOAD_CONTINUE:
+        case schedOVERLOAD_SKIP_NEXT:
+          pxCurrentTask->xOverrunHandled = pdTRUE;
+          schedTRACE( schedTRACE_BUDGET_EXHAUSTED, pxCurrentTask, xTickCount, pdTRUE );
+          return;
+        case schedOVERLOAD_ABORT_JOB:
+          pxCurrentTask->xAbortJob = pdTRUE;
+          break;
+        default:
+          break;
+      }
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+
+    schedTRACE( schedTRACE_BUDGET_EXHAUSTED, pxCurrentTask, xTickCount, pdTRUE );
     pxCurrentTask->xMaxExecTimeExceeded = pdTRUE;
-    /* Is not suspended yet, but will be suspended by the scheduler later. */
-    pxCurrentTask->xSuspended = pdTRUE;
-    pxCurrentTask->xAbsoluteUnblockTime = pxCurrentTask->xLastWakeTime + pxCurrentTask->xPeriod;
-    pxCurrentTask->xExecTime = 0;
-    #if (POLLING_SERVER == 1)  
-      if( pdTRUE == pxCurrentTask->isPollingServer )
+    /* An aborted job is not suspended, the scheduler task recreates the task. */
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      if( pdFALSE == pxCurrentTask->xAbortJob )
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+    {
+      /* Is not suspended yet, which is not possible from an interrupt. The
+       * scheduler task, woken below, suspends it before it runs again. */
+      pxCurrentTask->xSuspended = pdTRUE;
+      #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+        if( pdTRUE == pxCurrentTask->isPollingServer )
+        {
+          /* The budget is not refilled at the next period but by the pending
+           * replenishments. Resume the server when the first one is due. */
+          prvSporadicServerCloseChunk( pxCurrentTask );
+          pxCurrentTask->xAbsoluteUnblockTime = pxCurrentTask->xReplenishTime[ pxCurrentTask->uxReplenishHead ];
+        }
+        else
+      #endif /* POLLING_SERVER_MODE */
       {
-        pxCurrentTask->xAbsoluteDeadline = pxCurrentTask->xAbsoluteUnblockTime + pxCurrentTask->xRelativeDeadline;
+        pxCurrentTask->xAbsoluteUnblockTime = pxCurrentTask->xLastWakeTime + pxCurrentTask->xPeriod;
+        pxCurrentTask->xExecTime = 0;
+        #if (POLLING_SERVER == 1)  
+          if( pdTRUE == pxCurrentTask->isPollingServer )
+          {
+            pxCurrentTask->xAbsoluteDeadline = pxCurrentTask->xAbsoluteUnblockTime + pxCurrentTask->xRelativeDeadline;
+          }
+        #endif
       }
-    #endif
+    }
+    #if( schedUSE_TIMING_EVENT_HEAP == 1 )
+      /* Make the task due now, so the scheduler task suspends it. */
+      UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+      prvTimingHeapSet( pxCurrentTask, xTickCount );
+      taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    #endif /* schedUSE_TIMING_EVENT_HEAP */
     BaseType_t xHigherPriorityTaskWoken; 
     vTaskNotifyGiveFromISR( xSchedulerHandle, &xHigherPriorityTaskWoken ); 
     xTaskResumeFromISR(xSchedulerHandle);    
@@ -553,10 +2690,10 @@ static void prvSetFixedPriorities( void )
       pxNewTCB = &xTCBArray[ xIndex ];  
     #endif /* schedUSE_TCB_ARRAY */
 
-    pxNewTCB->pvTaskCode = (TaskFunction_t) executeAperiodicJob;
-    pxNewTCB->pcName = "Server";
-    pxNewTCB->uxStackDepth = configMINIMAL_STACK_SIZE;
-    pxNewTCB->pvParameters = NULL;
+    prvGetColdTCB( pxNewTCB )->pvTaskCode = (TaskFunction_t) executeAperiodicJob;
+    prvGetColdTCB( pxNewTCB )->pcName = "Server";
+    prvGetColdTCB( pxNewTCB )->uxStackDepth = configMINIMAL_STACK_SIZE;
+    prvGetColdTCB( pxNewTCB )->pvParameters = NULL;
     pxNewTCB->uxPriority = POLLING_SERVER_PRIORITY;
     pxNewTCB->pxTaskHandle = &pollingSeverTaskHandle;
     pxNewTCB->xReleaseTime = 0;
@@ -566,12 +2703,17 @@ static void prvSetFixedPriorities( void )
     pxNewTCB->xAbsoluteDeadline = pxNewTCB->xRelativeDeadline + pxNewTCB->xReleaseTime;    
     pxNewTCB->xWorkIsDone = pdTRUE;
     pxNewTCB->xExecTime = 0;    
+    #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+      prvResetExecTime( pxNewTCB );
+      prvGetColdTCB( pxNewTCB )->xExecTimeStats.ulLastJobMicros = 0;
+      prvGetColdTCB( pxNewTCB )->xExecTimeStats.ulMaxJobMicros = 0;
+    #endif /* schedUSE_SUBTICK_ACCOUNTING */
     
     #if( schedUSE_TCB_ARRAY == 1 )
       pxNewTCB->xInUse = pdTRUE;
     #endif /* schedUSE_TCB_ARRAY */
     
-    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS || schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
+    #if( schedFIXED_PRIORITY_POLICY )
       pxNewTCB->xPriorityIsSet = pdFALSE; 
     #endif /* schedSCHEDULING_POLICY */
     
@@ -588,6 +2730,28 @@ static void prvSetFixedPriorities( void )
       pxNewTCB->isPollingServer = pdTRUE;
     #endif
 
+    #if( schedUSE_MODE_CHANGE == 1 )
+      pxNewTCB->uxModes = schedALL_MODES;
+      pxNewTCB->xDormant = pdFALSE;
+      pxNewTCB->xMaxExecTime = xModeServerBudget[ uxCurrentMode ];
+    #endif /* schedUSE_MODE_CHANGE */
+
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      /* The budget of the server is always enforced. */
+      prvOverloadInit( pxNewTCB );
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+
+    #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+      pxNewTCB->xHeapPosition = -1;
+    #endif /* schedUSE_TIMING_EVENT_HEAP */
+
+    #if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+      pxNewTCB->uxReplenishHead = 0;
+      pxNewTCB->uxReplenishCount = 0;
+      pxNewTCB->xChunkActive = pdFALSE;
+      pxSporadicServerTCB = pxNewTCB;
+    #endif /* POLLING_SERVER_MODE */
+
     #if( schedUSE_TCB_ARRAY == 1 )
       xTaskCounter++; 
     #endif /* schedUSE_TCB_SORTED_LIST */
@@ -608,6 +2772,14 @@ static void prvSetFixedPriorities( void )
         return;
       }
     #endif
+
+    #if( schedUSE_MODE_CHANGE == 1 )
+      /* A task waiting for its mode has no job and no deadline. */
+      if( pdTRUE == pxTCB->xDormant )
+      {
+        return;
+      }
+    #endif /* schedUSE_MODE_CHANGE */
     
     #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )      
       
@@ -633,11 +2805,19 @@ static void prvSetFixedPriorities( void )
       if( pdTRUE == pxTCB->xMaxExecTimeExceeded )
       {        
         pxTCB->xMaxExecTimeExceeded = pdFALSE;
-        Serial.begin(9600);
-        Serial.print("Suspend Task ");
-        Serial.println(pxTCB->pcName);
-        Serial.end();
-        vTaskSuspend( *pxTCB->pxTaskHandle );
+        #if( schedUSE_OVERLOAD_POLICIES == 1 )
+          if( pdTRUE == pxTCB->xAbortJob )
+          {
+            /* Cleared when the task is recreated. */
+            prvAbortJob( pxTCB );
+          }
+          else
+        #endif /* schedUSE_OVERLOAD_POLICIES */
+        {
+          prvLogEvent( schedLOG_TASK_SUSPENDED, pxTCB, NULL );
+          schedTRACE( schedTRACE_SUSPEND, pxTCB, xTickCount, pdFALSE );
+          vTaskSuspend( *pxTCB->pxTaskHandle );
+        }
       }
       if( pdTRUE == pxTCB->xSuspended )
       {     
@@ -645,10 +2825,8 @@ static void prvSetFixedPriorities( void )
         {
           pxTCB->xSuspended = pdFALSE;
           pxTCB->xLastWakeTime = xTickCount;
-          Serial.begin(9600);
-          Serial.print("Resume Task ");
-          Serial.println(pxTCB->pcName);
-          Serial.end();
+          prvLogEvent( schedLOG_TASK_RESUMED, pxTCB, NULL );
+          schedTRACE( schedTRACE_RESUME, pxTCB, xTickCount, pdFALSE );
           vTaskResume( *pxTCB->pxTaskHandle );
         }
       }
@@ -657,18 +2835,196 @@ static void prvSetFixedPriorities( void )
     return;
   }
 
+  #if( schedUSE_TIMING_EVENT_HEAP == 1 )
+    /* Moves the TCB at uxPosition up or down until the heap is ordered again. */
+    static void prvTimingHeapSift( UBaseType_t uxPosition )
+    {
+      SchedTCB_t *pxTCB = pxTimingHeap[ uxPosition ];
+      UBaseType_t uxChild;
+
+      while( uxPosition > 0 && ( signed ) ( pxTCB->xNextEventTime - pxTimingHeap[ ( uxPosition - 1 ) / 2 ]->xNextEventTime ) < 0 )
+      {
+        pxTimingHeap[ uxPosition ] = pxTimingHeap[ ( uxPosition - 1 ) / 2 ];
+        pxTimingHeap[ uxPosition ]->xHeapPosition = uxPosition;
+        uxPosition = ( uxPosition - 1 ) / 2;
+      }
+      for( ; ; )
+      {
+        uxChild = 2 * uxPosition + 1;
+        if( uxChild >= uxTimingHeapSize )
+        {
+          break;
+        }
+        if( uxChild + 1 < uxTimingHeapSize &&
+            ( signed ) ( pxTimingHeap[ uxChild + 1 ]->xNextEventTime - pxTimingHeap[ uxChild ]->xNextEventTime ) < 0 )
+        {
+          uxChild++;
+        }
+        if( ( signed ) ( pxTimingHeap[ uxChild ]->xNextEventTime - pxTCB->xNextEventTime ) >= 0 )
+        {
+          break;
+        }
+        pxTimingHeap[ uxPosition ] = pxTimingHeap[ uxChild ];
+        pxTimingHeap[ uxPosition ]->xHeapPosition = uxPosition;
+        uxPosition = uxChild;
+      }
+      pxTimingHeap[ uxPosition ] = pxTCB;
+      pxTCB->xHeapPosition = uxPosition;
+    }
+
+    /* Inserts the task into the heap, or moves it, with event time xTime. */
+    static void prvTimingHeapSet( SchedTCB_t *pxTCB, TickType_t xTime )
+    {
+      pxTCB->xNextEventTime = xTime;
+      if( -1 == pxTCB->xHeapPosition )
+      {
+        pxTimingHeap[ uxTimingHeapSize ] = pxTCB;
+        pxTCB->xHeapPosition = uxTimingHeapSize;
+        uxTimingHeapSize++;
+      }
+      prvTimingHeapSift( pxTCB->xHeapPosition );
+    }
+
+    /* Removes the task from the heap, if it has a pending event. */
+    static void prvTimingHeapRemove( SchedTCB_t *pxTCB )
+    {
+      UBaseType_t uxPosition;
+
+      if( -1 == pxTCB->xHeapPosition )
+      {
+        return;
+      }
+      uxPosition = pxTCB->xHeapPosition;
+      pxTCB->xHeapPosition = -1;
+      uxTimingHeapSize--;
+      if( uxPosition != uxTimingHeapSize )
+      {
+        pxTimingHeap[ uxPosition ] = pxTimingHeap[ uxTimingHeapSize ];
+        prvTimingHeapSift( uxPosition );
+      }
+    }
+
+    /* Derives the next timing event of a task from its state: its unblock
+     * time if it is suspended, and the first tick after its deadline once it
+     * has been released. Must be called inside a critical section. */
+    static void prvUpdateTimingEvent( SchedTCB_t *pxTCB )
+    {
+      BaseType_t xHasEvent = pdFALSE;
+      TickType_t xTime = 0;
+
+      if( pdFALSE == pxTCB->xInUse )
+      {
+        prvTimingHeapRemove( pxTCB );
+        return;
+      }
+
+      #if( schedUSE_MODE_CHANGE == 1 )
+        if( pdTRUE == pxTCB->xDormant )
+        {
+          prvTimingHeapRemove( pxTCB );
+          return;
+        }
+      #endif /* schedUSE_MODE_CHANGE */
+
+      #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
+        if( pdTRUE == pxTCB->xMaxExecTimeExceeded )
+        {
+          /* Already due, the scheduler task has not suspended it yet. */
+          return;
+        }
+        if( pdTRUE == pxTCB->xSuspended )
+        {
+          xTime = pxTCB->xAbsoluteUnblockTime;
+          xHasEvent = pdTRUE;
+        }
+      #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
+
+      #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )
+        #if( POLLING_SERVER == 1 )
+          if( pdTRUE == pxTCB->xExecutedOnce && pdTRUE != pxTCB->isPollingServer )
+        #else
+          if( pdTRUE == pxTCB->xExecutedOnce )
+        #endif /* POLLING_SERVER */
+        {
+          /* prvCheckDeadline reports a miss once the tick count has passed the
+           * deadline, and only once for a job that is let run on. */
+          TickType_t xDeadlineCheck = pxTCB->xAbsoluteDeadline + 1;
+          if( ( pdFALSE == xHasEvent || ( signed ) ( xDeadlineCheck - xTime ) < 0 )
+          #if( schedUSE_OVERLOAD_POLICIES == 1 )
+              && pdFALSE == pxTCB->xMissHandled
+          #endif /* schedUSE_OVERLOAD_POLICIES */
+            )
+          {
+            xTime = xDeadlineCheck;
+            xHasEvent = pdTRUE;
+          }
+        }
+      #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
+
+      if( pdTRUE == xHasEvent )
+      {
+        prvTimingHeapSet( pxTCB, xTime );
+      }
+      else
+      {
+        prvTimingHeapRemove( pxTCB );
+      }
+    }
+  #endif /* schedUSE_TIMING_EVENT_HEAP */
+
   /* Function code for the scheduler task. */
   static void prvSchedulerFunction( void *pvParameters )
   {   
+    #if( schedUSE_OVERHEAD_STATS == 1 )
+      unsigned long ulOverheadStart;
+    #endif /* schedUSE_OVERHEAD_STATS */
+
     for( ; ; )
     { 
+      #if( schedUSE_OVERHEAD_STATS == 1 )
+        ulOverheadStart = schedREAD_OVERHEAD_CLOCK();
+      #endif /* schedUSE_OVERHEAD_STATS */
+
+      #if( schedUSE_STATIC_ALLOCATION == 1 )
+        if( NULL != xPendingDeleteHandle )
+        {
+          vTaskDelete( xPendingDeleteHandle );
+          xPendingDeleteHandle = NULL;
+        }
+      #endif /* schedUSE_STATIC_ALLOCATION */
+
       #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 || schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
         TickType_t xTickCount = xTaskGetTickCount();        
         SchedTCB_t *pxTCB;
 
-        #if( schedUSE_TCB_ARRAY == 1 )
+        #if( schedUSE_TIMING_EVENT_HEAP == 1 )
+          /* Only check the tasks whose event is due. Every task is checked at
+           * most once per wake up, even if its next event is due right away. */
+          BaseType_t xIndex;
+          for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+          {
+            taskENTER_CRITICAL();
+            pxTCB = NULL;
+            if( 0 != uxTimingHeapSize && ( signed ) ( pxTimingHeap[ 0 ]->xNextEventTime - xTickCount ) <= 0 )
+            {
+              pxTCB = pxTimingHeap[ 0 ];
+              prvTimingHeapRemove( pxTCB );
+            }
+            taskEXIT_CRITICAL();
+
+            if( NULL == pxTCB )
+            {
+              break;
+            }
+            prvSchedulerCheckTimingError( xTickCount, pxTCB );
+
+            taskENTER_CRITICAL();
+            prvUpdateTimingEvent( pxTCB );
+            taskEXIT_CRITICAL();
+          }
+        #elif( schedUSE_TCB_ARRAY == 1 )
           BaseType_t xIndex;
-          for( xIndex = 0; xIndex < xTaskCounter; xIndex++ )
+          for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
           {
             pxTCB = &xTCBArray[ xIndex ];
             prvSchedulerCheckTimingError( xTickCount, pxTCB );
@@ -677,14 +3033,160 @@ static void prvSetFixedPriorities( void )
       
       #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE || schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
 
+      #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+        /* Every wake up follows a release, a completion, a timing error or a
+         * server deadline change, each of which can change the ranking. */
+        prvEDFSetPriorities( xTaskGetTickCount() );
+      #endif /* schedSCHEDULING_POLICY */
+
+      #if( schedUSE_OVERHEAD_STATS == 1 )
+        prvRecordOverhead( schedOVERHEAD_SCHEDULER_TASK, ulOverheadStart );
+      #endif /* schedUSE_OVERHEAD_STATS */
       ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
     }
   }
 
+  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+    /* pdTRUE if the task has a released job that is not done. Every job is
+     * released at its absolute deadline minus the relative deadline, which
+     * is also right for the next job of a task that is done, and for a task
+     * that waits for its phase after it was recreated. */
+    static BaseType_t prvEDFIsReady( SchedTCB_t *pxTCB, TickType_t xTickCount )
+    {
+      if( pdFALSE == pxTCB->xInUse )
+      {
+        return pdFALSE;
+      }
+      #if( schedUSE_MODE_CHANGE == 1 )
+        if( pdTRUE == pxTCB->xDormant )
+        {
+          return pdFALSE;
+        }
+      #endif /* schedUSE_MODE_CHANGE */
+      #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
+        if( pdTRUE == pxTCB->xSuspended )
+        {
+          return pdFALSE;
+        }
+      #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
+      #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+        if( pdTRUE == pxTCB->isPollingServer )
+        {
+          /* The CBS has no releases, it is ready while it has work. */
+          return ( pdFALSE == pxTCB->xWorkIsDone ) ? pdTRUE : pdFALSE;
+        }
+      #endif /* POLLING_SERVER_MODE */
+      return ( ( signed ) ( xTickCount - ( pxTCB->xAbsoluteDeadline - pxTCB->xRelativeDeadline ) ) >= 0 ) ? pdTRUE : pdFALSE;
+    }
+
+    /* Ranks the ready jobs by absolute deadline, one level each from
+     * schedEDF_PRIORITY_HIGH down. Ties keep the order of the TCB array.
+     * The jobs that are left when schedEDF_PRIORITY_LOW is reached share it
+     * with the tasks that have no ready job, see scheduler.h. Also finds the
+     * next release, at which the tick hook wakes the scheduler task again. */
+    static void prvEDFSetPriorities( TickType_t xTickCount )
+    {
+      BaseType_t xIndex;
+      UBaseType_t uxLevel;
+      SchedTCB_t *pxTCB, *pxEarliest;
+      TickType_t xRelease;
+      #if( schedUSE_OVERHEAD_STATS == 1 )
+        unsigned long ulOverheadStart = schedREAD_OVERHEAD_CLOCK();
+      #endif /* schedUSE_OVERHEAD_STATS */
+
+      /* The tick hook changes the CBS deadline. */
+      taskENTER_CRITICAL();
+      for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+      {
+        xTCBArray[ xIndex ].xPriorityIsSet = pdFALSE;
+        xTCBArray[ xIndex ].uxPriority = schedEDF_PRIORITY_LOW;
+      }
+      for( uxLevel = schedEDF_PRIORITY_HIGH; uxLevel > schedEDF_PRIORITY_LOW; uxLevel-- )
+      {
+        pxEarliest = NULL;
+        for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+        {
+          pxTCB = &xTCBArray[ xIndex ];
+          if( pdFALSE == pxTCB->xPriorityIsSet && pdTRUE == prvEDFIsReady( pxTCB, xTickCount ) &&
+              ( NULL == pxEarliest || ( signed ) ( pxTCB->xAbsoluteDeadline - pxEarliest->xAbsoluteDeadline ) < 0 ) )
+          {
+            pxEarliest = pxTCB;
+          }
+        }
+        if( NULL == pxEarliest )
+        {
+          break;
+        }
+        pxEarliest->uxPriority = uxLevel;
+        pxEarliest->xPriorityIsSet = pdTRUE;
+      }
+
+      xEDFReleasePending = pdFALSE;
+      for( xIndex = 0; xIndex < schedMAX_NUMBER_OF_PERIODIC_TASKS; xIndex++ )
+      {
+        pxTCB = &xTCBArray[ xIndex ];
+        if( pdFALSE == pxTCB->xInUse )
+        {
+          continue;
+        }
+        #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+          if( pdTRUE == pxTCB->isPollingServer )
+          {
+            continue;
+          }
+        #endif /* POLLING_SERVER_MODE */
+        #if( schedUSE_MODE_CHANGE == 1 )
+          if( pdTRUE == pxTCB->xDormant )
+          {
+            continue;
+          }
+        #endif /* schedUSE_MODE_CHANGE */
+        xRelease = pxTCB->xAbsoluteDeadline - pxTCB->xRelativeDeadline;
+        if( ( signed ) ( xRelease - xTickCount ) > 0 &&
+            ( pdFALSE == xEDFReleasePending || ( signed ) ( xRelease - xEDFNextRelease ) < 0 ) )
+        {
+          xEDFNextRelease = xRelease;
+          xEDFReleasePending = pdTRUE;
+        }
+      }
+      taskEXIT_CRITICAL();
+
+      #if( schedUSE_OVERHEAD_STATS == 1 )
+        prvRecordOverhead( schedOVERHEAD_PRIORITY_ASSIGNMENT, ulOverheadStart );
+      #endif /* schedUSE_OVERHEAD_STATS */
+      prvApplyPriorities();
+    }
+
+    /* pdTRUE if the next release found by the last ranking is due. Called
+     * every tick, the ranking that follows finds the release after it. Every
+     * change of a release time is followed by a ranking. */
+    static BaseType_t prvEDFReleaseDue( TickType_t xTickCount )
+    {
+      if( pdTRUE == xEDFReleasePending && ( signed ) ( xTickCount - xEDFNextRelease ) >= 0 )
+      {
+        xEDFReleasePending = pdFALSE;
+        return pdTRUE;
+      }
+      return pdFALSE;
+    }
+
+    /* Asks the scheduler task to rank the jobs again. Must not be called
+     * from an interrupt. */
+    static void prvEDFReschedule( void )
+    {
+      xTaskNotifyGive( xSchedulerHandle );
+    }
+  #endif /* schedSCHEDULING_POLICY */
+
   /* Creates the scheduler task. */
   static void prvCreateSchedulerTask( void )
   {
-    xTaskCreate( (TaskFunction_t) prvSchedulerFunction, "Scheduler", schedSCHEDULER_TASK_STACK_SIZE, NULL, schedSCHEDULER_PRIORITY, &xSchedulerHandle );                
+    #if( schedUSE_STATIC_ALLOCATION == 1 )
+      xSchedulerHandle = xTaskCreateStatic( (TaskFunction_t) prvSchedulerFunction, "Scheduler", schedSCHEDULER_TASK_STACK_SIZE, NULL, schedSCHEDULER_PRIORITY,
+          xSchedulerStack, &xSchedulerTaskBuffer );
+    #else
+      xTaskCreate( (TaskFunction_t) prvSchedulerFunction, "Scheduler", schedSCHEDULER_TASK_STACK_SIZE, NULL, schedSCHEDULER_PRIORITY, &xSchedulerHandle );
+    #endif /* schedUSE_STATIC_ALLOCATION */                
   }
 #endif /* schedUSE_SCHEDULER_TASK */
 
@@ -698,43 +3200,138 @@ static void prvSetFixedPriorities( void )
     xTaskResumeFromISR(xSchedulerHandle);    
   }
 
-  /* Called every software tick. */
-  void vApplicationTickHook()
-  {            
-    SchedTCB_t *pxCurrentTask;
-    TaskHandle_t xCurrentTaskHandle = xTaskGetCurrentTaskHandle();
+  /* Recharges the CBS, or hands a task that has used up its worst-case
+   * execution time to prvExecTimeExceedHook. Called from the tick hook or
+   * the budget timer for the running task. Returns pdTRUE if the scheduler
+   * task was woken. */
+  static BaseType_t prvEnforceBudget( SchedTCB_t *pxCurrentTask, TickType_t xTickCount )
+  {
+    BaseType_t xWoken = pdFALSE;
 
-    configASSERT(xCurrentTaskHandle != xSchedulerHandle);
+    ( void ) xTickCount;
+    #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_CBS )
+      if( pdTRUE == pxCurrentTask->isPollingServer && pxCurrentTask->xMaxExecTime <= pxCurrentTask->xExecTime )
+      {
+        /* The CBS is not suspended: its budget is recharged and its
+         * deadline postponed by one period, which ranks it lower. */
+        pxCurrentTask->xExecTime = 0;
+        pxCurrentTask->xAbsoluteDeadline += pxCurrentTask->xPeriod;
+        schedTRACE( schedTRACE_REPLENISH, pxCurrentTask, xTickCount, pdTRUE );
+        prvWakeScheduler();
+        xWoken = pdTRUE;
+      }
+    #endif /* POLLING_SERVER_MODE */
+    #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
+      if( pxCurrentTask->xMaxExecTime <= pxCurrentTask->xExecTime )
+      {
+        if( pdFALSE == pxCurrentTask->xMaxExecTimeExceeded )
+        {
+          if( pdFALSE == pxCurrentTask->xSuspended )
+          {            
+            prvExecTimeExceedHook( xTickCount, pxCurrentTask );
+            xWoken = pxCurrentTask->xMaxExecTimeExceeded;
+          }
+        }
+      }
+    #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
+    return xWoken;
+  }
 
-    BaseType_t xIndex;
-    for (xIndex = 0; xIndex < xTaskCounter; xIndex++)
+  #if( schedUSE_BUDGET_TIMER == 1 )
+    /* Arms the budget timer with the budget pxTCB, which is switched in, has
+     * left. Tasks whose overrun is already handled run without it. */
+    static void prvBudgetTimerStart( SchedTCB_t *pxTCB )
     {
-        /* your implementation goes here */
-        pxCurrentTask = &xTCBArray[xIndex];
+      unsigned long ulBudget, ulUsed;
 
-        if (*(pxCurrentTask->pxTaskHandle) == xCurrentTaskHandle) {
-            break;
+      if( NULL == pxTCB || pdTRUE == pxTCB->xSuspended || pdTRUE == pxTCB->xMaxExecTimeExceeded )
+      {
+        return;
+      }
+      #if( schedUSE_OVERLOAD_POLICIES == 1 )
+        if( pdTRUE == pxTCB->xOverrunHandled )
+        {
+          return;
         }
+      #endif /* schedUSE_OVERLOAD_POLICIES */
+
+      ulBudget = ( unsigned long ) pxTCB->xMaxExecTime * schedMICROS_PER_TICK;
+      ulUsed = ( unsigned long ) pxTCB->xExecTime * schedMICROS_PER_TICK + pxTCB->ulExecMicros;
+      schedBUDGET_TIMER_ARM( ( ulUsed < ulBudget ) ? ulBudget - ulUsed : 1UL );
     }
 
-    if( xCurrentTaskHandle != xSchedulerHandle && xCurrentTaskHandle != xTaskGetIdleTaskHandle())
+    BaseType_t xSchedulerBudgetTimerExpired( void )
     {
-      pxCurrentTask->xExecTime++;
-      #if( schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME == 1 )
-        if( pxCurrentTask->xMaxExecTime <= pxCurrentTask->xExecTime )
+      SchedTCB_t *pxTCB = prvGetTCBFromHandle( xTaskGetCurrentTaskHandle() );
+      BaseType_t xWoken = pdFALSE;
+
+      if( NULL != pxTCB )
+      {
+        prvChargeExecTime( pxTCB, schedREAD_MICROS() );
+        xWoken = prvEnforceBudget( pxTCB, xTaskGetTickCountFromISR() );
+        /* The timer may expire before the budget is used up, when it is
+         * longer than the timer range or rounded. A recharged CBS starts a
+         * new budget. */
+        prvBudgetTimerStart( pxTCB );
+      }
+      return xWoken;
+    }
+  #endif /* schedUSE_BUDGET_TIMER */
+
+  /* Called every software tick. */
+  void vApplicationTickHook()
+  {            
+    #if( schedUSE_OVERHEAD_STATS == 1 )
+      unsigned long ulOverheadStart = schedREAD_OVERHEAD_CLOCK();
+    #endif /* schedUSE_OVERHEAD_STATS */
+    TaskHandle_t xCurrentTaskHandle = xTaskGetCurrentTaskHandle();
+    /* NULL for the idle task and the scheduler task, which have no extended TCB. */
+    SchedTCB_t *pxCurrentTask = prvGetTCBFromHandle( xCurrentTaskHandle );
+
+    #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+      if( NULL != pxSporadicServerTCB )
+      {
+        prvSporadicServerReplenish( pxSporadicServerTCB, xTaskGetTickCountFromISR() );
+      }
+    #endif /* POLLING_SERVER_MODE */
+
+    if( NULL != pxCurrentTask )
+    {
+      #if( POLLING_SERVER == 1 && POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+        if( pxCurrentTask == pxSporadicServerTCB && pdFALSE == pxCurrentTask->xChunkActive )
         {
-          if( pdFALSE == pxCurrentTask->xMaxExecTimeExceeded )
-          {
-            if( pdFALSE == pxCurrentTask->xSuspended )
-            {            
-              prvExecTimeExceedHook( xTaskGetTickCountFromISR(), pxCurrentTask );
-            }
-          }
+          /* The server becomes active: its replenishment time is one period from now. */
+          pxCurrentTask->xChunkActive = pdTRUE;
+          pxCurrentTask->xActivationTime = xTaskGetTickCountFromISR();
+          pxCurrentTask->xChunkStartExecTime = pxCurrentTask->xExecTime;
         }
-      #endif /* schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME */
+      #endif /* POLLING_SERVER_MODE */
+      #if( schedUSE_BUDGET_TIMER != 1 )
+        #if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+          /* Only the time since the last switch or tick is charged. */
+          prvChargeExecTime( pxCurrentTask, schedREAD_MICROS() );
+        #else
+          pxCurrentTask->xExecTime++;
+        #endif /* schedUSE_SUBTICK_ACCOUNTING */
+        ( void ) prvEnforceBudget( pxCurrentTask, xTaskGetTickCountFromISR() );
+      #endif /* schedUSE_BUDGET_TIMER */
     }
 
-    #if( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )    
+    #if( schedUSE_BUDGET_TIMER == 1 && schedBUDGET_TIMER_ON_TICK == 1 )
+      if( pdTRUE == xBudgetTimerArmed && ( signed ) ( xTaskGetTickCountFromISR() - xBudgetTimerExpiry ) >= 0 )
+      {
+        xBudgetTimerArmed = pdFALSE;
+        ( void ) xSchedulerBudgetTimerExpired();
+      }
+    #endif /* schedBUDGET_TIMER_ON_TICK */
+
+    #if( schedUSE_TIMING_EVENT_HEAP == 1 )
+      /* Wake the scheduler task as soon as the earliest timing event is due. */
+      if( 0 != uxTimingHeapSize && ( signed ) ( pxTimingHeap[ 0 ]->xNextEventTime - xTaskGetTickCountFromISR() ) <= 0 )
+      {
+        prvWakeScheduler();
+      }
+    #elif( schedUSE_TIMING_ERROR_DETECTION_DEADLINE == 1 )    
       xSchedulerWakeCounter++;      
       if( xSchedulerWakeCounter == schedSCHEDULER_TASK_PERIOD )
       {
@@ -742,35 +3339,287 @@ static void prvSetFixedPriorities( void )
         prvWakeScheduler();
       }
     #endif /* schedUSE_TIMING_ERROR_DETECTION_DEADLINE */
+
+    #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+      /* A released job may have an earlier deadline than the running one. */
+      if( pdTRUE == prvEDFReleaseDue( xTaskGetTickCountFromISR() ) )
+      {
+        prvWakeScheduler();
+      }
+    #endif /* schedSCHEDULING_POLICY */
+
+    #if( schedUSE_OVERHEAD_STATS == 1 )
+      prvRecordOverhead( schedOVERHEAD_TICK_HOOK, ulOverheadStart );
+    #endif /* schedUSE_OVERHEAD_STATS */
   }
 #endif /* schedUSE_SCHEDULER_TASK */
 
+/* Prints one log event. */
+static void prvPrintLogEvent( uint8_t ucEvent, const char *pcText )
+{
+  switch( ucEvent )
+  {
+    case schedLOG_DEADLINE_MISSED:
+      Serial.print("Missed Deadline ");
+      break;
+    case schedLOG_TASK_SUSPENDED:
+      Serial.print("Suspend Task ");
+      break;
+    case schedLOG_TASK_RESUMED:
+      Serial.print("Resume Task ");
+      break;
+    case schedLOG_TASK_REJECTED:
+      Serial.print("Unschedulable Task ");
+      break;
+    case schedLOG_TASK_SET_OVERLOADED:
+      Serial.print("Overloaded Task Set");
+      break;
+    case schedLOG_FIRM_VIOLATED:
+      Serial.print("(m,k) Violated ");
+      break;
+    default:
+      break;
+  }
+  Serial.println(pcText);
+}
+
+/* Logs an event of pxTCB, or the message pcMessage. With schedUSE_EVENT_LOG
+ * only a record is written, interrupts are masked for a few instructions. */
+static void prvLogEvent( uint8_t ucEvent, SchedTCB_t *pxTCB, const char *pcMessage )
+{
+  #if( schedUSE_EVENT_LOG == 1 )
+    SchedLogRecord_t *pxRecord;
+
+    taskENTER_CRITICAL();
+    if( ( UBaseType_t ) ( uxEventLogTail - uxEventLogHead ) != schedEVENT_LOG_SIZE )
+    {
+      pxRecord = &xEventLog[ uxEventLogTail % schedEVENT_LOG_SIZE ];
+      pxRecord->pcText = ( NULL == pxTCB ) ? pcMessage : prvGetColdTCB( pxTCB )->pcName;
+      pxRecord->xTickCount = xTaskGetTickCount();
+      pxRecord->ucEvent = ucEvent;
+      uxEventLogTail++;
+    }
+    else
+    {
+      ulEventLogDropped++;
+    }
+    taskEXIT_CRITICAL();
+  #else
+    Serial.begin(schedLOG_BAUD_RATE);
+    prvPrintLogEvent( ucEvent, ( NULL == pxTCB ) ? pcMessage : prvGetColdTCB( pxTCB )->pcName );
+    Serial.end();
+  #endif /* schedUSE_EVENT_LOG */
+}
+
+void vSchedulerLogMessage( const char *pcMessage )
+{
+  prvLogEvent( schedLOG_MESSAGE, NULL, pcMessage );
+}
+
+#if( schedUSE_EVENT_LOG == 1 )
+  void vSchedulerLogFlush( void )
+  {
+    static BaseType_t xSerialStarted = pdFALSE;
+    SchedLogRecord_t xRecord;
+    unsigned long ulDropped;
+
+    if( pdFALSE == xSerialStarted )
+    {
+      Serial.begin(schedLOG_BAUD_RATE);
+      xSerialStarted = pdTRUE;
+    }
+
+    taskENTER_CRITICAL();
+    ulDropped = ulEventLogDropped;
+    ulEventLogDropped = 0;
+    taskEXIT_CRITICAL();
+    if( 0 != ulDropped )
+    {
+      Serial.print("Log dropped ");
+      Serial.println(ulDropped);
+    }
+
+    for( ; ; )
+    {
+      /* Copy the record out, so that it is printed with interrupts enabled. */
+      taskENTER_CRITICAL();
+      if( uxEventLogHead == uxEventLogTail )
+      {
+        taskEXIT_CRITICAL();
+        break;
+      }
+      xRecord = xEventLog[ uxEventLogHead % schedEVENT_LOG_SIZE ];
+      uxEventLogHead++;
+      taskEXIT_CRITICAL();
+
+      Serial.print((unsigned long) xRecord.xTickCount);
+      Serial.print(": ");
+      prvPrintLogEvent( xRecord.ucEvent, xRecord.pcText );
+    }
+  }
+#endif /* schedUSE_EVENT_LOG */
+
+#if( schedUSE_STATIC_TASK_SET == 1 )
+  /* Creates the tasks of xSchedTaskSet from uxIndex on, in the TCB slots
+   * with the same index. The recursion is unrolled by the compiler, so the
+   * parameters of each task are constants in the code. */
+  template< UBaseType_t uxIndex > static void prvCreateTaskSet( void );
+  template<> void prvCreateTaskSet< schedTASK_SET_PERIODIC_TASKS >( void )
+  {
+  }
+
+  template< UBaseType_t uxIndex > static void prvCreateTaskSet( void )
+  {
+    vSchedulerPeriodicTaskCreate( xSchedTaskSet[ uxIndex ].pvTaskCode, xSchedTaskSet[ uxIndex ].pcName, xSchedTaskSet[ uxIndex ].uxStackDepth,
+        xSchedTaskSet[ uxIndex ].pvParameters, uxSchedTaskSetPriority( uxIndex ), xSchedTaskSet[ uxIndex ].pxCreatedTask,
+        xSchedTaskSet[ uxIndex ].xPhaseTick, xSchedTaskSet[ uxIndex ].xPeriodTick, xSchedTaskSet[ uxIndex ].xMaxExecTimeTick,
+        xSchedTaskSet[ uxIndex ].xDeadlineTick );
+    prvCreateTaskSet< uxIndex + 1 >();
+  }
+
+  /* Gives the tasks from uxIndex on, the polling server included, the
+   * priority and the response time found at compile time. */
+  template< UBaseType_t uxIndex > static void prvSetTaskSetPriorities( void );
+  template<> void prvSetTaskSetPriorities< schedTASK_SET_SIZE >( void )
+  {
+  }
+
+  template< UBaseType_t uxIndex > static void prvSetTaskSetPriorities( void )
+  {
+    constexpr UBaseType_t uxPriority = uxSchedTaskSetPriority( uxIndex );
+
+    xTCBArray[ uxIndex ].uxPriority = uxPriority;
+    xTCBArray[ uxIndex ].xPriorityIsSet = pdTRUE;
+    #if( schedUSE_ADMISSION_CONTROL == 1 )
+    {
+      constexpr TickType_t xResponseTime = ulSchedTaskSetWorstCaseResponseTime( uxIndex );
+
+      xTCBArray[ uxIndex ].xWorstCaseResponseTime = xResponseTime;
+    }
+    #endif /* schedUSE_ADMISSION_CONTROL */
+    prvSetTaskSetPriorities< uxIndex + 1 >();
+  }
+#endif /* schedUSE_STATIC_TASK_SET */
+
+/* Prints one line of vSchedulerPrintMemoryFootprint. */
+static void prvPrintFootprintLine( const char *pcName, unsigned long ulBytes )
+{
+  Serial.print(pcName);
+  Serial.print(": ");
+  Serial.println(ulBytes);
+}
+
+/* Prints the static RAM used by the scheduler. */
+void vSchedulerPrintMemoryFootprint( void )
+{
+  unsigned long ulTotal = sizeof( xTCBArray ) + sizeof( xTCBColdArray );
+
+  Serial.print("Tasks: ");
+  Serial.println((unsigned long) schedMAX_NUMBER_OF_PERIODIC_TASKS);
+  prvPrintFootprintLine( "TCB hot per task", sizeof( SchedTCB_t ) );
+  prvPrintFootprintLine( "TCB cold per task", sizeof( SchedTCBCold_t ) );
+  prvPrintFootprintLine( "TCB hot", sizeof( xTCBArray ) );
+  prvPrintFootprintLine( "TCB cold", sizeof( xTCBColdArray ) );
+
+  #if( schedUSE_SCHEDULER_TASK == 1 && schedUSE_TIMING_EVENT_HEAP == 1 )
+    prvPrintFootprintLine( "Timing heap", sizeof( pxTimingHeap ) );
+    ulTotal += sizeof( pxTimingHeap );
+  #endif /* schedUSE_TIMING_EVENT_HEAP */
+
+  #if( schedUSE_STATIC_ALLOCATION == 1 )
+    prvPrintFootprintLine( "Task stacks", sizeof( xTaskStacks ) + sizeof( xSchedulerStack ) );
+    prvPrintFootprintLine( "Task buffers", sizeof( xTaskBuffers ) + sizeof( xSchedulerTaskBuffer ) );
+    ulTotal += sizeof( xTaskStacks ) + sizeof( xSchedulerStack ) + sizeof( xTaskBuffers ) + sizeof( xSchedulerTaskBuffer );
+  #endif /* schedUSE_STATIC_ALLOCATION */
+
+  #if( POLLING_SERVER == 1 )
+  {
+    unsigned long ulQueue = sizeof( aperiodicTCBQueue ) + sizeof( aperiodicJobReady ) + sizeof( xResumableJobs );
+
+    #if( POLLING_SERVER_QUEUE_ORDER == POLLING_SERVER_QUEUE_EDF )
+      ulQueue += sizeof( xAperiodicHeap );
+    #else
+      ulQueue += sizeof( xDeferredAperiodicJobs );
+    #endif /* POLLING_SERVER_QUEUE_ORDER */
+    prvPrintFootprintLine( "Aperiodic queue", ulQueue );
+    ulTotal += ulQueue;
+  }
+  #endif /* POLLING_SERVER */
+
+  #if( schedUSE_EVENT_LOG == 1 )
+    prvPrintFootprintLine( "Event log", sizeof( xEventLog ) );
+    ulTotal += sizeof( xEventLog );
+  #endif /* schedUSE_EVENT_LOG */
+
+  #if( schedUSE_TRACE == 1 )
+    prvPrintFootprintLine( "Trace buffer", sizeof( xTraceBuffer ) );
+    ulTotal += sizeof( xTraceBuffer );
+  #endif /* schedUSE_TRACE */
+
+  #if( schedUSE_OVERHEAD_STATS == 1 )
+    prvPrintFootprintLine( "Overhead stats", sizeof( xOverheadStats ) );
+    ulTotal += sizeof( xOverheadStats );
+  #endif /* schedUSE_OVERHEAD_STATS */
+
+  prvPrintFootprintLine( "Total", ulTotal );
+}
+
 /* This function must be called before any other function call from this module. */
 void vSchedulerInit( void )
 {
   #if( schedUSE_TCB_ARRAY == 1 )
     prvInitTCBArray();
   #endif /* schedUSE_TCB_ARRAY */
+
+  #if( schedUSE_MODE_CHANGE == 1 && POLLING_SERVER == 1 )
+    UBaseType_t uxMode;
+    for( uxMode = 0; uxMode < schedMAX_NUMBER_OF_MODES; uxMode++ )
+    {
+      xModeServerBudget[ uxMode ] = POLLING_SERVER_MAX_EXEC_TIME;
+    }
+  #endif /* schedUSE_MODE_CHANGE */
 }
 
 /* Starts scheduling tasks. All periodic tasks (including polling server) must
  * have been created with API function before calling this function. */
 void vSchedulerStart( void )
 { 
+  #if( schedUSE_STATIC_TASK_SET == 1 )
+    prvCreateTaskSet< 0 >();
+  #endif /* schedUSE_STATIC_TASK_SET */
+
   #if (POLLING_SERVER == 1)
     prvCreatePollingServerTask();
   #endif /* POLLING_SERVER */
   
-  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS)
+  #if( schedUSE_STATIC_TASK_SET == 1 )
+    /* Ranked and analysed by the compiler. */
+    prvSetTaskSetPriorities< 0 >();
+  #elif( schedFIXED_PRIORITY_POLICY )
     prvSetFixedPriorities();  
+  #elif( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+    /* No task is created yet, this only sets the initial ranks. */
+    prvEDFSetPriorities( xTaskGetTickCount() );
   #endif /* schedSCHEDULING_POLICY */
 
+  #if( schedUSE_ADMISSION_CONTROL == 1 && schedUSE_STATIC_TASK_SET == 0 )
+    if( schedADMISSION_OK != prvAdmitTaskSet() )
+    {
+      #if( schedUSE_EVENT_LOG == 1 )
+        /* loop() never runs, print the reason right away. */
+        vSchedulerLogFlush();
+      #endif /* schedUSE_EVENT_LOG */
+      return;
+    }
+  #endif /* schedUSE_ADMISSION_CONTROL */
+
   #if( schedUSE_SCHEDULER_TASK == 1 )
     prvCreateSchedulerTask();
   #endif /* schedUSE_SCHEDULER_TASK */
 
+  xSystemStartTime = xTaskGetTickCount();
   prvCreateAllTasks();
     
-  xSystemStartTime = xTaskGetTickCount();
+  xSchedulerStarted = pdTRUE;
   vTaskStartScheduler();
 }
@@ -20,6 +20,8 @@
 #include <queue.h>
 #include <Arduino.h>
 
+#include "schedTrace.h"
+
 
 
 #ifdef __cplusplus
@@ -28,21 +30,60 @@ extern "C" {
 
 /* The scheduling policy can be chosen from one of these. */
 #define schedSCHEDULING_POLICY_RMS 1 		/* Rate-monotonic scheduling */
+#define schedSCHEDULING_POLICY_DMS 2 		/* Deadline-monotonic scheduling */
+#define schedSCHEDULING_POLICY_EDF 3 		/* Earliest deadline first, needs the scheduler task */
+#define schedSCHEDULING_POLICY_OPA 4 		/* Audsley's optimal priority assignment, by response-time analysis */
+
+
+/* Configure scheduling policy by setting this define to the appropriate one.
+ * Can be overridden by the build. */
+#ifndef schedSCHEDULING_POLICY
+  #define schedSCHEDULING_POLICY schedSCHEDULING_POLICY_RMS
+#endif
 
+/* schedSCHEDULING_POLICY_OPA gives every periodic task, the polling server
+ * included, its own level between the idle task and the scheduler task,
+ * which leaves configMAX_PRIORITIES - 2 levels. Further tasks share the
+ * lowest level, where the assignment is no longer optimal. Such a set is
+ * still checked by schedUSE_ADMISSION_CONTROL, and rejected if a task of
+ * the shared level can miss its deadline. */
 
-/* Configure scheduling policy by setting this define to the appropriate one. */
-#define schedSCHEDULING_POLICY schedSCHEDULING_POLICY_RMS
+/* Set this define to 1 to give the periodic task set at compile time, in
+ * the header named by schedTASK_SET_HEADER, instead of creating the tasks
+ * with vSchedulerPeriodicTaskCreate. Their priorities are then ranked and
+ * the set is analysed by the compiler, see schedTaskSet.h. Only with
+ * schedSCHEDULING_POLICY_RMS or schedSCHEDULING_POLICY_DMS. Can be
+ * overridden by the build. */
+#ifndef schedUSE_STATIC_TASK_SET
+  #define schedUSE_STATIC_TASK_SET 0
+#endif
+
+#ifndef schedTASK_SET_HEADER
+  #define schedTASK_SET_HEADER "taskSet.h"
+#endif
 
 /* Maximum number of periodic tasks that can be created. (Scheduler task is
- * not included, but Polling Server is included) */
-#define schedMAX_NUMBER_OF_PERIODIC_TASKS 5
+ * not included, but Polling Server is included) Can be overridden by the
+ * build, vSchedulerPrintMemoryFootprint shows what it costs. With
+ * schedUSE_STATIC_TASK_SET, it is the size of the task set. */
+#ifndef schedMAX_NUMBER_OF_PERIODIC_TASKS
+  #if( schedUSE_STATIC_TASK_SET == 1 )
+    #define schedMAX_NUMBER_OF_PERIODIC_TASKS ( ( int ) schedTASK_SET_SIZE )
+  #else
+    #define schedMAX_NUMBER_OF_PERIODIC_TASKS 5
+  #endif /* schedUSE_STATIC_TASK_SET */
+#endif
 
-/* Maximum number of aperiodic tasks that can be created. */
-#define schedMAX_NUMBER_OF_APERIODIC_TASKS 2
+/* Maximum number of aperiodic jobs that can be queued at the same time.
+ * Must be a power of two, and can be overridden by the build. */
+#ifndef schedMAX_NUMBER_OF_APERIODIC_TASKS
+  #define schedMAX_NUMBER_OF_APERIODIC_TASKS 8
+#endif
 
 /* Set this define to 1 to enable Timing-Error-Detection for detecting tasks
  * that have missed their deadlines. Tasks that have missed their deadlines
- * will be deleted, recreated and restarted during next period. */
+ * will be deleted, recreated and restarted during next period, unless their
+ * overload policy says otherwise. */
 #define schedUSE_TIMING_ERROR_DETECTION_DEADLINE 1
 
 /* Set this define to 1 to enable Timing-Error-Detection for detecting tasks
@@ -52,14 +93,215 @@ extern "C" {
 
 #define schedUSE_SCHEDULER_TASK 1
 
+/* Set this define to 1 to measure execution time in microseconds at every
+ * task switch, instead of charging a whole tick to the task that runs when
+ * the tick interrupt occurs. A task that runs for less than a tick between
+ * two ticks is charged too, and budgets are enforced on the measured time.
+ * traceTASK_SWITCHED_IN() and traceTASK_SWITCHED_OUT() must call
+ * vSchedulerTraceTaskSwitchedIn() and vSchedulerTraceTaskSwitchedOut() in
+ * FreeRTOSConfig.h. Can be overridden by the build. */
+#ifndef schedUSE_SUBTICK_ACCOUNTING
+  #define schedUSE_SUBTICK_ACCOUNTING 0
+#endif
+
+/* Set this define to 1 to detect overruns of worst-case execution times and
+ * server budgets with a one-shot timer, instead of checking the running task
+ * in every tick. The timer is armed with the budget a task has left when it
+ * is switched in, and disarmed when it is switched out, so an overrun is
+ * caught when it happens. The timer interrupt does not stop the task itself,
+ * since FreeRTOS can neither suspend nor delete a task from an interrupt. It
+ * marks the overrun and switches straight to the scheduler task, which has
+ * the highest priority, and which suspends the task or aborts its job before
+ * the task runs again. Enforcement therefore still takes the two context
+ * switches through the scheduler task. Needs schedUSE_SUBTICK_ACCOUNTING and
+ * schedUSE_TIMING_ERROR_DETECTION_EXECUTION_TIME. On the board, Timer1 is
+ * used. Elsewhere, the build can provide schedBUDGET_TIMER_ARM( ulMicros )
+ * and schedBUDGET_TIMER_DISARM(), and the timer interrupt must call
+ * xSchedulerBudgetTimerExpired(). Without them, as on the host and in the
+ * simulator, there is no timer: the expiry is rounded up to whole ticks and
+ * polled by the tick hook, so an overrun is caught no earlier than without
+ * the timer, and that fallback only exercises the code paths. Can be
+ * overridden by the build. */
+#ifndef schedUSE_BUDGET_TIMER
+  #define schedUSE_BUDGET_TIMER 0
+#endif
+
+/* Free running microsecond counter of schedUSE_SUBTICK_ACCOUNTING. On the
+ * board, micros() reads Timer0, which the FreeRTOS port leaves running, with
+ * a resolution of 4 us. Must be callable from interrupts. */
+#ifndef schedREAD_MICROS
+  #define schedREAD_MICROS() micros()
+#endif
+
+/* Set this define to 1 to measure the time the scheduler itself takes in
+ * the tick hook, in each activation of the scheduler task and in each
+ * ranking of the task priorities, see vSchedulerGetOverheadStats. Can be
+ * overridden by the build. */
+#ifndef schedUSE_OVERHEAD_STATS
+  #define schedUSE_OVERHEAD_STATS 0
+#endif
+
+/* Free running counter the overhead is measured with, schedREAD_MICROS()
+ * unless the build provides a finer one. The host builds count
+ * nanoseconds. Must be callable from interrupts. */
+#ifndef schedREAD_OVERHEAD_CLOCK
+  #define schedREAD_OVERHEAD_CLOCK() schedREAD_MICROS()
+#endif
+
+/* Set this define to 1 to choose, per periodic task, how a job that misses
+ * its deadline or exceeds its worst-case execution time is handled, see the
+ * schedOVERLOAD_ policies and vSchedulerPeriodicTaskSetOverloadPolicy. Needs
+ * schedUSE_TIMING_ERROR_DETECTION_DEADLINE and the scheduler task. Can be
+ * overridden by the build. */
+#ifndef schedUSE_OVERLOAD_POLICIES
+  #define schedUSE_OVERLOAD_POLICIES 0
+#endif
+
+/* Set this define to 1 to create the periodic tasks, the polling server and
+ * the scheduler task with xTaskCreateStatic, from stacks and task buffers
+ * that are reserved at compile time, one per TCB slot. No heap is used after
+ * vSchedulerStart, and a task that misses its deadline is recreated in the
+ * same buffers. Needs configSUPPORT_STATIC_ALLOCATION and the scheduler task.
+ * Can be overridden by the build. */
+#ifndef schedUSE_STATIC_ALLOCATION
+  #define schedUSE_STATIC_ALLOCATION 0
+#endif
+
+/* Stack size in words of every periodic task and the polling server with
+ * schedUSE_STATIC_ALLOCATION. The stack depth a task is created with must
+ * not be larger. It sizes arrays, so it must be a constant; the default is
+ * configMINIMAL_STACK_SIZE of the Arduino FreeRTOS library. Can be
+ * overridden by the build. */
+#ifndef schedSTATIC_STACK_DEPTH
+  #define schedSTATIC_STACK_DEPTH 192
+#endif
+
+/* Set this define to 1 to check the task set, including the polling server,
+ * with a worst-case response-time analysis in vSchedulerStart and in every
+ * vSchedulerPeriodicTaskCreate call after it. Sets that can miss a deadline
+ * are rejected. Off by default, since the worst-case execution times of the
+ * pollingServer.ino demo add up to more than 100 %. Can be overridden by the
+ * build. */
+#ifndef schedUSE_ADMISSION_CONTROL
+  #define schedUSE_ADMISSION_CONTROL 0
+#endif
+
+/* Set this define to 1 to check timing errors only when they are due. The
+ * next deadline check and unblock time of every task are kept in a min-heap,
+ * and the tick hook wakes the scheduler task as soon as the earliest one is
+ * due. Set it to 0 to scan all tasks every schedSCHEDULER_TASK_PERIOD ticks.
+ * Can be overridden by the build. */
+#ifndef schedUSE_TIMING_EVENT_HEAP
+  #define schedUSE_TIMING_EVENT_HEAP 1
+#endif
+
+/* Set this define to 1 to defer the scheduler diagnostics ("Missed Deadline",
+ * "Suspend Task", "Resume Task") and vSchedulerLogMessage() output. Events are
+ * stored as small binary records in a ring buffer, and only formatted and
+ * printed by vSchedulerLogFlush() from loop(). Set it to 0 to print every
+ * event on the spot. */
+#define schedUSE_EVENT_LOG 1
+
+/* Number of records in the event log. Must be a power of two, and can be
+ * overridden by the build. Events that do not fit are dropped and counted. */
+#ifndef schedEVENT_LOG_SIZE
+  #define schedEVENT_LOG_SIZE 16
+#endif
+
+/* Baud rate of the serial port the log is printed on. */
+#define schedLOG_BAUD_RATE 9600
+
+/* Set this define to 1 to record a binary scheduling trace (see schedTrace.h)
+ * in a RAM buffer: job releases, starts and completions, aperiodic jobs,
+ * timing errors and, if traceTASK_SWITCHED_IN() is defined to call
+ * vSchedulerTraceTaskSwitchedIn() in FreeRTOSConfig.h, every task switch.
+ * Can be overridden by the build. */
+#ifndef schedUSE_TRACE
+  #define schedUSE_TRACE 0
+#endif
+
+/* Number of records in the trace buffer. Must be a power of two and at most
+ * 128, and can be overridden by the build. Records that do not fit are
+ * dropped until the buffer is read, and reported with schedTRACE_OVERFLOW. */
+#ifndef schedTRACE_BUFFER_SIZE
+  #define schedTRACE_BUFFER_SIZE 64
+#endif
+
+/* Set this define to 1 to support operating modes, each with its own subset
+ * of the periodic tasks and its own polling server budget. Can be overridden
+ * by the build. */
+#ifndef schedUSE_MODE_CHANGE
+  #define schedUSE_MODE_CHANGE 0
+#endif
+
+/* Task notification index on which a task that is not part of the current
+ * mode waits, so that index 0 stays free for the application. Needs
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES above this index. */
+#ifndef schedMODE_NOTIFICATION_INDEX
+  #define schedMODE_NOTIFICATION_INDEX 1
+#endif
+
+/* Number of operating modes, at most 8. Mode 0 is active at start. */
+#define schedMAX_NUMBER_OF_MODES 4
+
 #define POLLING_SERVER 1
 
 
 #if( POLLING_SERVER == 1)
 #define POLLING_SERVER_PRIORITY     ( configMAX_PRIORITIES - 2 )
-#define POLLING_SERVER_PERIOD        pdMS_TO_TICKS( 200 )
-#define POLLING_SERVER_MAX_EXEC_TIME        pdMS_TO_TICKS( 100 )
-#define POLLING_SERVER_RELATIVE_DEADLINE        pdMS_TO_TICKS( 200 )
+/* Period and budget of the server. They can be overridden by the build, and
+ * only need to be constants for schedUSE_STATIC_TASK_SET. */
+#ifndef POLLING_SERVER_PERIOD
+  #define POLLING_SERVER_PERIOD        pdMS_TO_TICKS( 200 )
+#endif
+#ifndef POLLING_SERVER_MAX_EXEC_TIME
+  #define POLLING_SERVER_MAX_EXEC_TIME        pdMS_TO_TICKS( 100 )
+#endif
+#ifndef POLLING_SERVER_RELATIVE_DEADLINE
+  #define POLLING_SERVER_RELATIVE_DEADLINE        POLLING_SERVER_PERIOD
+#endif
+
+/* The aperiodic server policy can be chosen from one of these. */
+#define POLLING_SERVER_MODE_POLLING 1      /* Serves queued jobs at release, gives up the budget when the queue is empty. */
+#define POLLING_SERVER_MODE_DEFERRABLE 2   /* Keeps the unused budget until the end of the period and serves jobs on arrival. */
+#define POLLING_SERVER_MODE_SPORADIC 3     /* Serves jobs on arrival, consumed budget is replenished one period after it was used. */
+#define POLLING_SERVER_MODE_CBS 4          /* Constant bandwidth server, only with schedSCHEDULING_POLICY_EDF. Serves jobs on arrival,
+                                            * an exhausted budget is recharged at once and the server deadline is postponed by one period. */
+
+/* Configure the aperiodic server policy by setting this define to the appropriate one.
+ * Can be overridden by the build. */
+#ifndef POLLING_SERVER_MODE
+  #define POLLING_SERVER_MODE POLLING_SERVER_MODE_POLLING
+#endif
+
+#if( POLLING_SERVER_MODE == POLLING_SERVER_MODE_SPORADIC )
+  /* Maximum number of pending budget replenishments of the sporadic server.
+   * When the list is full, new consumption is merged into the latest entry,
+   * which only delays replenishment and therefore stays schedulable. */
+  #define POLLING_SERVER_MAX_REPLENISHMENTS 4
+#endif /* POLLING_SERVER_MODE */
+
+/* Set this define to 1 to also serve aperiodic jobs in the background, in
+ * time that periodic tasks and the server leave unused. The application must
+ * call vSchedulerBackgroundServe() from loop(), which the Arduino FreeRTOS
+ * port runs from the idle hook. Background jobs are not charged to the
+ * server budget, and must not block. */
+#define POLLING_SERVER_BACKGROUND_SERVICE 0
+
+/* The order in which queued aperiodic jobs are served can be chosen from one of these. */
+#define POLLING_SERVER_QUEUE_FIFO 1   /* In order of arrival. */
+#define POLLING_SERVER_QUEUE_EDF 2    /* Earliest deadline first, jobs without deadline last in order of arrival. */
+
+/* Configure the aperiodic job order by setting this define to the appropriate one. */
+#define POLLING_SERVER_QUEUE_ORDER POLLING_SERVER_QUEUE_FIFO
+
+/* Number of buckets of the aperiodic lateness histogram. Bucket 0 counts jobs
+ * that met their deadline, bucket n > 0 jobs that were late by 2^(n-1) to
+ * 2^n - 1 ticks, and the last bucket all jobs that were later than that. */
+#define POLLING_SERVER_LATENESS_BUCKETS 8
+
+/* Maximum number of resumable aperiodic jobs that can be pending at the same time. */
+#define POLLING_SERVER_MAX_RESUMABLE_JOBS 2
 
 
 /* Aperiodic Task control block for managing periodic tasks within this library. */
@@ -69,31 +311,140 @@ typedef struct aperiodicExtended_TCB
   const char *pcName;       /* Name of the task. */
   void *pvParameters;       /* Parameters to the task function. */
   TaskHandle_t *pxTaskHandle;   /* Task handle for the task. */
+  TickType_t xReleaseTime;    /* Time at which the job was queued. */
+  TickType_t xAbsoluteDeadline; /* Soft deadline of the job, only valid if xHasDeadline is pdTRUE. */
+  TickType_t xMaxExecTime;    /* Estimated execution time of the job, 0 if unknown. */
+  BaseType_t xHasDeadline;    /* pdTRUE if the job was created with a deadline. */
 } AJTCB_t;
 
+/* Step function of a resumable aperiodic job. Does a bounded amount of work
+ * on the job state pvState and returns pdTRUE when the job is complete, or
+ * pdFALSE if it needs more steps. */
+typedef BaseType_t ( *AJStepFunction_t )( void *pvState );
+
+/* Lateness of the aperiodic jobs that were created with a deadline. */
+typedef struct aperiodicLateness
+{
+  unsigned long ulJobs;       /* Completed jobs with a deadline. */
+  unsigned long ulLateJobs;   /* Jobs that completed after their deadline. */
+  TickType_t xMaxLateness;    /* Largest lateness seen so far. */
+  unsigned long ulHistogram[ POLLING_SERVER_LATENESS_BUCKETS ];
+} AJLateness_t;
+
   /* Wrapper funtions for queue insertion and deletion */
   BaseType_t createAperiodicJob(TaskFunction_t pvTaskCode, \
                                    const char *pcName, void *pvParameters, \
                    TaskHandle_t *pxCreatedTask);
 
-  static BaseType_t getEmptyIndexInQueue (void);
+  /* Same as createAperiodicJob, but can be called from an interrupt service
+   * routine. *pxHigherPriorityTaskWoken is set to pdTRUE if the server was
+   * woken and a context switch should be requested before the ISR exits. */
+  BaseType_t xCreateAperiodicJobFromISR(TaskFunction_t pvTaskCode, \
+                                   const char *pcName, void *pvParameters, \
+                   TaskHandle_t *pxCreatedTask, BaseType_t *pxHigherPriorityTaskWoken);
+
+  /* Same as createAperiodicJob, but the job has a soft deadline of
+   * xRelativeDeadline ticks from now and an estimated execution time of
+   * xMaxExecTime ticks. The deadline decides the order in which jobs are
+   * served if POLLING_SERVER_QUEUE_ORDER is POLLING_SERVER_QUEUE_EDF, and the
+   * lateness of the job is recorded in either order. The server only starts
+   * the job when xMaxExecTime fits its remaining budget, 0 means unknown. */
+  BaseType_t xCreateAperiodicJobWithDeadline(TaskFunction_t pvTaskCode, \
+                                   const char *pcName, void *pvParameters, \
+                   TaskHandle_t *pxCreatedTask, TickType_t xRelativeDeadline, TickType_t xMaxExecTime);
+
+  /* Same as xCreateAperiodicJobWithDeadline, but can be called from an
+   * interrupt service routine, like xCreateAperiodicJobFromISR. */
+  BaseType_t xCreateAperiodicJobWithDeadlineFromISR(TaskFunction_t pvTaskCode, \
+                                   const char *pcName, void *pvParameters, \
+                   TaskHandle_t *pxCreatedTask, TickType_t xRelativeDeadline, TickType_t xMaxExecTime, \
+                   BaseType_t *pxHigherPriorityTaskWoken);
+
+  /* Creates a resumable aperiodic job that is split into steps. pxStepCode is
+   * called with pvState until it returns pdTRUE. Each step is expected to take
+   * at most xStepExecTime ticks. Steps only use the server budget that
+   * queued jobs leave unused, a step is only started if xStepExecTime fits
+   * what is left of it, and a job that is not complete at the end of the
+   * budget continues in the next period. Returns pdFALSE if xStepExecTime is
+   * 0 or larger than POLLING_SERVER_MAX_EXEC_TIME, or if
+   * POLLING_SERVER_MAX_RESUMABLE_JOBS jobs are already pending. Must not be
+   * called from an interrupt. */
+  BaseType_t xCreateResumableAperiodicJob(AJStepFunction_t pxStepCode, \
+                                   const char *pcName, void *pvState, TickType_t xStepExecTime);
+
+  /* Copies the lateness statistics of aperiodic jobs into pxLateness. */
+  void vSchedulerGetAperiodicLateness( AJLateness_t *pxLateness );
+
+  static BaseType_t getEmptyIndexInQueue (BaseType_t xFromISR);
   static void executeAperiodicJob(void);
 
+  #if( POLLING_SERVER_BACKGROUND_SERVICE == 1 )
+    /* Number of aperiodic jobs completed by the server and in the background. */
+    typedef struct aperiodicStats
+    {
+      unsigned long ulServerJobs;
+      unsigned long ulBackgroundJobs;
+    } AJStats_t;
+
+    /* Runs at most one queued aperiodic job. Must be called from loop(). */
+    void vSchedulerBackgroundServe( void );
+
+    /* Copies the aperiodic job counters into pxStats. */
+    void vSchedulerGetAperiodicStats( AJStats_t *pxStats );
+  #endif /* POLLING_SERVER_BACKGROUND_SERVICE */
+
 #endif
 
 #if( schedUSE_SCHEDULER_TASK == 1 )
 	/* Priority of the scheduler task. */
 	#define schedSCHEDULER_PRIORITY ( configMAX_PRIORITIES - 1 )
-	/* Stack size of the scheduler task. */
-	#define schedSCHEDULER_TASK_STACK_SIZE 200
-	/* The period of the scheduler task in software ticks. */
+	/* Stack size of the scheduler task. Can be overridden by the build, the
+	 * host build needs at least PTHREAD_STACK_MIN. */
+	#ifndef schedSCHEDULER_TASK_STACK_SIZE
+		#define schedSCHEDULER_TASK_STACK_SIZE 200
+	#endif
+	/* The period of the scheduler task in software ticks. Not used with
+	 * schedUSE_TIMING_EVENT_HEAP. */
 	#define schedSCHEDULER_TASK_PERIOD pdMS_TO_TICKS( 200 )	
+
+	#if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_EDF )
+		/* Under EDF, the scheduler task ranks the released jobs by absolute
+		 * deadline at every release and completion, and gives each its own
+		 * level from schedEDF_PRIORITY_HIGH down. Tasks without a released job
+		 * are blocked at schedEDF_PRIORITY_LOW. The schedule is exact EDF while
+		 * at most configMAX_PRIORITIES - 2 jobs are released at once. Beyond
+		 * that, the jobs with the latest deadlines share the lowest level and
+		 * run round robin among themselves, but still only when no job with an
+		 * earlier deadline is ready. */
+		#define schedEDF_PRIORITY_HIGH ( schedSCHEDULER_PRIORITY - 1 )
+		#define schedEDF_PRIORITY_LOW 1
+	#endif /* schedSCHEDULING_POLICY */
 #endif /* schedUSE_SCHEDULER_TASK */
 
+#if( schedUSE_ADMISSION_CONTROL == 1 )
+	/* Results of the admission control. */
+	#define schedADMISSION_OK 0
+	#define schedADMISSION_OVERLOAD 1   /* Total utilization is above 100 %. */
+	#define schedADMISSION_DEADLINE 2   /* A worst-case response time exceeds the deadline of a task,
+	                                     * or under EDF the density sum( C / min( D, T ) ) is above 100 %. */
+#endif /* schedUSE_ADMISSION_CONTROL */
+
+/* Errors of xSchedulerPeriodicTaskCreate, next to the kernel's
+ * errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY when the task cannot be created. */
+#define schedERROR_NO_TCB_SLOT ( -2 )      /* All schedMAX_NUMBER_OF_PERIODIC_TASKS slots are in use. */
+#define schedERROR_NOT_ADMITTED ( -3 )     /* Rejected by the admission control, see xSchedulerGetAdmissionResult. */
+
 /* This function must be called before any other function call from scheduler.h. */
 void vSchedulerInit( void );
 
-/* Creates a periodic task.
+/* Creates a periodic task. It can also be called after vSchedulerStart: the
+ * task is then created right away, and the priorities of all tasks are ranked
+ * again. With schedUSE_ADMISSION_CONTROL, it is only created if it passes the
+ * admission control, see xSchedulerGetAdmissionResult.
+ *
+ * Returns pdPASS, or one of the errors above. Before vSchedulerStart the task
+ * is only registered, so only schedERROR_NO_TCB_SLOT is reported; the whole
+ * set is checked and created by vSchedulerStart.
  *
  * pvTaskCode: The task function.
  * pcName: Name of the task.
@@ -101,23 +452,189 @@ void vSchedulerInit( void );
  * pvParameters: Parameters to the task function.
  * uxPriority: Priority of the task. (Only used when scheduling policy is set to manual)
  * pxCreatedTask: Pointer to the task handle.
- * xPhaseTick: Phase given in software ticks. Counted from when vSchedulerStart is called.
+ * xPhaseTick: Phase given in software ticks. Counted from when vSchedulerStart is called,
+ *             or from the call itself for tasks created after vSchedulerStart.
  * xPeriodTick: Period given in software ticks.
  * xMaxExecTimeTick: Worst-case execution time given in software ticks.
  * xDeadlineTick: Relative deadline given in software ticks.
  * */
+BaseType_t xSchedulerPeriodicTaskCreate( TaskFunction_t pvTaskCode, const char *pcName, UBaseType_t uxStackDepth, void *pvParameters, UBaseType_t uxPriority,
+		TaskHandle_t *pxCreatedTask, TickType_t xPhaseTick, TickType_t xPeriodTick, TickType_t xMaxExecTimeTick, TickType_t xDeadlineTick );
+
+/* Same as xSchedulerPeriodicTaskCreate without the result, for existing
+ * sketches. A full TCB array still fails configASSERT. */
 void vSchedulerPeriodicTaskCreate( TaskFunction_t pvTaskCode, const char *pcName, UBaseType_t uxStackDepth, void *pvParameters, UBaseType_t uxPriority,
 		TaskHandle_t *pxCreatedTask, TickType_t xPhaseTick, TickType_t xPeriodTick, TickType_t xMaxExecTimeTick, TickType_t xDeadlineTick );
 
-/* Deletes a periodic task associated with the given task handle. */
+/* Deletes a periodic task associated with the given task handle, NULL for the
+ * calling task. The remaining tasks are ranked again if the scheduler runs. */
 void vSchedulerPeriodicTaskDelete( TaskHandle_t xTaskHandle );
 
-/* Starts scheduling tasks. */
+/* Starts scheduling tasks. Returns only if the task set is rejected by the
+ * admission control. */
 void vSchedulerStart( void );
 
+#if( schedUSE_OVERLOAD_POLICIES == 1 )
+	/* The overload policy of a periodic task can be chosen from one of these. */
+	#define schedOVERLOAD_RECREATE 0    /* Default. A late job is aborted by deleting and recreating the task, an
+	                                     * overrunning job is suspended until the next period. */
+	#define schedOVERLOAD_CONTINUE 1    /* A late or overrunning job runs to completion. */
+	#define schedOVERLOAD_SKIP_NEXT 2   /* As schedOVERLOAD_CONTINUE, and the releases that have passed when the
+	                                     * job completes are skipped, at least one. */
+	#define schedOVERLOAD_FIRM 3        /* (m,k)-firm: at least m of any k consecutive jobs must meet their
+	                                     * deadline. A late job is aborted. An overrunning job is aborted if one
+	                                     * more miss keeps the constraint, and runs on otherwise. */
+	#define schedOVERLOAD_ABORT_JOB 4   /* A late or overrunning job is aborted, the next job is released on time. */
+
+	/* Maximum k of the (m,k)-firm constraint. */
+	#define schedOVERLOAD_FIRM_MAX_K 16
+
+	/* Overload counters of a periodic task. */
+	typedef struct schedOverloadStats
+	{
+	  unsigned long ulCompleted;      /* Jobs that ran to completion. */
+	  unsigned long ulLate;           /* Completed jobs that missed their deadline. */
+	  unsigned long ulMissed;         /* Deadline misses. */
+	  unsigned long ulOverruns;       /* Jobs that exceeded the worst-case execution time. */
+	  unsigned long ulAborted;        /* Jobs that were aborted. */
+	  unsigned long ulSkipped;        /* Releases that were skipped. */
+	  unsigned long ulFirmViolations; /* Misses that broke the (m,k)-firm constraint. */
+	} SchedOverloadStats_t;
+
+	/* Sets the overload policy of the periodic task created with
+	 * pxCreatedTask, one of the schedOVERLOAD_ defines. uxM and uxK are the
+	 * (m,k)-firm constraint, 0 < uxM <= uxK <= schedOVERLOAD_FIRM_MAX_K, and
+	 * only used by schedOVERLOAD_FIRM. Can be called before or after
+	 * vSchedulerStart, and resets the (m,k) history. */
+	void vSchedulerPeriodicTaskSetOverloadPolicy( TaskHandle_t *pxCreatedTask, UBaseType_t uxPolicy, UBaseType_t uxM, UBaseType_t uxK );
+
+	/* Copies the overload counters of the task into pxStats. A NULL handle
+	 * refers to the calling task. */
+	void vSchedulerGetOverloadStats( TaskHandle_t xTaskHandle, SchedOverloadStats_t *pxStats );
+#endif /* schedUSE_OVERLOAD_POLICIES */
+
+#if( schedUSE_MODE_CHANGE == 1 )
+	/* Bit of mode uxMode in a mode mask. */
+	#define schedMODE( uxMode ) ( ( UBaseType_t ) 1 << ( uxMode ) )
+	/* Mask of all modes, the default of every task. */
+	#define schedALL_MODES ( schedMODE( schedMAX_NUMBER_OF_MODES ) - 1 )
+
+	/* Sets the modes in which the periodic task created with pxCreatedTask
+	 * runs, as a mask of schedMODE() bits. Can be called before or after
+	 * vSchedulerStart. */
+	void vSchedulerPeriodicTaskSetModes( TaskHandle_t *pxCreatedTask, UBaseType_t uxModes );
+
+	/* Sets the polling server budget in mode uxMode. Defaults to
+	 * POLLING_SERVER_MAX_EXEC_TIME. */
+	void vSchedulerSetModeServerBudget( UBaseType_t uxMode, TickType_t xBudget );
+
+	/* Switches to mode uxMode. Tasks of both modes keep running unchanged.
+	 * Tasks that are not part of the new mode stop at the end of their
+	 * current job. Tasks that join are released once every leaving job has
+	 * passed its deadline, so the two task sets never overlap. The new
+	 * server budget applies from the next server period. Returns pdFAIL for
+	 * an invalid mode, or if the new task set is rejected by the admission
+	 * control. Must not be called from an interrupt. */
+	BaseType_t xSchedulerRequestModeChange( UBaseType_t uxMode );
+
+	/* Returns the current mode. */
+	UBaseType_t uxSchedulerGetMode( void );
+#endif /* schedUSE_MODE_CHANGE */
+
+#if( schedUSE_ADMISSION_CONTROL == 1 )
+	/* Returns the worst-case response time of the task, as computed by the
+	 * last admission check, or 0 if it is not a periodic task. Under EDF,
+	 * this is the deadline bound min( D, T ) the density test guarantees. A
+	 * NULL handle refers to the calling task. */
+	TickType_t xSchedulerGetWorstCaseResponseTime( TaskHandle_t xTaskHandle );
+
+	/* Returns the result of the last admission check, one of the
+	 * schedADMISSION_ defines. For schedADMISSION_DEADLINE, *ppcTaskName is
+	 * set to the name of the first task that can miss its deadline, or to
+	 * NULL under EDF, where the test is for the whole set. */
+	BaseType_t xSchedulerGetAdmissionResult( const char **ppcTaskName );
+#endif /* schedUSE_ADMISSION_CONTROL */
+
+/* Logs pcMessage, which must be a string constant, since only the pointer is
+ * stored until the log is flushed. Must not be called from an interrupt. */
+void vSchedulerLogMessage( const char *pcMessage );
+
+#if( schedUSE_EVENT_LOG == 1 )
+  /* Prints all pending log records. Must be called from loop() only. */
+  void vSchedulerLogFlush( void );
+#endif /* schedUSE_EVENT_LOG */
+
+/* Prints the bytes of static RAM used by the scheduler with the current
+ * configuration: the extended TCBs split into the part used while the tasks
+ * run and the part used at creation, and each buffer sized by the build. */
+void vSchedulerPrintMemoryFootprint( void );
+
+/* Records a schedTRACE_SWITCHED_IN event for the task that is switched in,
+ * and starts measuring its execution time. Meant to be called from
+ * traceTASK_SWITCHED_IN(), does nothing unless schedUSE_TRACE or
+ * schedUSE_SUBTICK_ACCOUNTING is 1. */
+void vSchedulerTraceTaskSwitchedIn( void );
+
+/* Charges the task that is switched out with the time it ran. Meant to be
+ * called from traceTASK_SWITCHED_OUT(), does nothing unless
+ * schedUSE_SUBTICK_ACCOUNTING is 1. */
+void vSchedulerTraceTaskSwitchedOut( void );
+
+#if( schedUSE_SUBTICK_ACCOUNTING == 1 )
+  /* Measured execution time of a periodic task, in microseconds. */
+  typedef struct schedExecTimeStats
+  {
+    unsigned long ulLastJobMicros;  /* Execution time of the last completed job. */
+    unsigned long ulMaxJobMicros;   /* Longest execution time of a completed job. */
+  } SchedExecTimeStats_t;
+
+  /* Copies the measured execution times of the task into pxStats. A NULL
+   * handle refers to the calling task. */
+  void vSchedulerGetExecTimeStats( TaskHandle_t xTaskHandle, SchedExecTimeStats_t *pxStats );
+#endif /* schedUSE_SUBTICK_ACCOUNTING */
+
+#if( schedUSE_OVERHEAD_STATS == 1 )
+  /* Parts of the scheduler whose execution time is measured. */
+  #define schedOVERHEAD_TICK_HOOK 0           /* vApplicationTickHook. */
+  #define schedOVERHEAD_SCHEDULER_TASK 1      /* One activation of the scheduler task. */
+  #define schedOVERHEAD_PRIORITY_ASSIGNMENT 2 /* One ranking of the task priorities. */
+  #define schedOVERHEAD_PARTS 3
+
+  /* Execution time of a part of the scheduler, in schedREAD_OVERHEAD_CLOCK()
+   * counts. */
+  typedef struct schedOverheadStats
+  {
+    unsigned long ulCalls;  /* Number of measured calls. */
+    unsigned long ulTotal;  /* Sum of their execution times. */
+    unsigned long ulMax;    /* Longest execution time. */
+  } SchedOverheadStats_t;
+
+  /* Copies the measured execution time of uxPart, one of the
+   * schedOVERHEAD_ defines, into pxStats. */
+  void vSchedulerGetOverheadStats( UBaseType_t uxPart, SchedOverheadStats_t *pxStats );
+#endif /* schedUSE_OVERHEAD_STATS */
+
+#if( schedUSE_BUDGET_TIMER == 1 )
+  /* Enforces the budget of the running task when the budget timer expires.
+   * Must be called from the timer interrupt. Returns pdTRUE if the scheduler
+   * task was woken, and a context switch should be requested before the
+   * interrupt exits. */
+  BaseType_t xSchedulerBudgetTimerExpired( void );
+#endif /* schedUSE_BUDGET_TIMER */
+
+#if( schedUSE_TRACE == 1 )
+  /* Moves up to uxMaxRecords trace records into pxRecords, oldest first, and
+   * returns how many were copied. Must be called from a single task only. */
+  UBaseType_t uxSchedulerTraceRead( SchedTraceRecord_t *pxRecords, UBaseType_t uxMaxRecords );
+#endif /* schedUSE_TRACE */
+
 #ifdef __cplusplus
 }
 #endif
 
+#if( schedUSE_STATIC_TASK_SET == 1 )
+  #include "schedTaskSet.h"
+#endif /* schedUSE_STATIC_TASK_SET */
+
 
 #endif /* SCHEDULER_H_ */
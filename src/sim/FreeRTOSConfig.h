@@ -0,0 +1,105 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* Kernel configuration for the scheduling simulator, see portmacro.h. It
+ * follows the host configuration, with a 1 kHz tick. Stacks are host stacks,
+ * and the server period and budget are variables, so that one binary can
+ * sweep them. */
+
+#define configUSE_PREEMPTION                      1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION   0
+#define configUSE_IDLE_HOOK                       1
+#define configUSE_TICK_HOOK                       1
+#define configUSE_DAEMON_TASK_STARTUP_HOOK        0
+#define configTICK_RATE_HZ                        ( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE                  ( ( unsigned short ) 8192 )
+#define configTOTAL_HEAP_SIZE                     ( ( size_t ) ( 256 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                   ( 12 )
+#define configUSE_TRACE_FACILITY                  0
+#define configUSE_16_BIT_TICKS                    0
+#define configIDLE_SHOULD_YIELD                   1
+#define configUSE_MUTEXES                         1
+#define configCHECK_FOR_STACK_OVERFLOW            0
+#define configUSE_RECURSIVE_MUTEXES               1
+#define configQUEUE_REGISTRY_SIZE                 0
+#define configUSE_MALLOC_FAILED_HOOK              0
+#define configUSE_APPLICATION_TASK_TAG            0
+#define configUSE_COUNTING_SEMAPHORES             1
+#define configUSE_TASK_NOTIFICATIONS              1
+/* Index 1 is used by the scheduler, see schedMODE_NOTIFICATION_INDEX. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES     2
+#ifndef configMAX_PRIORITIES
+  /* One level for each task slot, the server included, between the idle
+   * task and the scheduler task, so that tasks of random sets do not share
+   * levels. */
+  #define configMAX_PRIORITIES                    ( 11 )
+#endif
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS   1
+#define configSUPPORT_DYNAMIC_ALLOCATION          1
+#define configSUPPORT_STATIC_ALLOCATION           1
+
+#define configUSE_TIMERS                          0
+
+#define INCLUDE_vTaskPrioritySet                  1
+#define INCLUDE_uxTaskPriorityGet                 1
+#define INCLUDE_vTaskDelete                       1
+#define INCLUDE_vTaskSuspend                      1
+#define INCLUDE_xTaskDelayUntil                   1
+#define INCLUDE_vTaskDelayUntil                   1
+#define INCLUDE_vTaskDelay                        1
+#define INCLUDE_xTaskGetIdleTaskHandle            1
+#define INCLUDE_xTaskGetCurrentTaskHandle         1
+#define INCLUDE_xTaskResumeFromISR                1
+#define INCLUDE_xTaskAbortDelay                   1
+
+/* Nine slots for eight periodic tasks and the server, see configMAX_PRIORITIES. */
+#ifndef schedMAX_NUMBER_OF_PERIODIC_TASKS
+  #define schedMAX_NUMBER_OF_PERIODIC_TASKS 9
+#endif
+
+/* The scheduler task gets the same stack as the other tasks. */
+#define schedSCHEDULER_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+
+/* Tasks are created in static buffers, so that an aborted job recreates its
+ * task the way it does on a board without heap. */
+#ifndef schedUSE_STATIC_ALLOCATION
+  #define schedUSE_STATIC_ALLOCATION 1
+#endif
+#define schedSTATIC_STACK_DEPTH configMINIMAL_STACK_SIZE
+
+/* The per-task job counters of the results come from the overload policies. */
+#ifndef schedUSE_OVERLOAD_POLICIES
+  #define schedUSE_OVERLOAD_POLICIES 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void vHostAssertCalled( const char *pcFile, unsigned long ulLine );
+  void vSchedulerTraceTaskSwitchedIn( void );
+  void vSchedulerTraceTaskSwitchedOut( void );
+  unsigned long ulHostMonotonicMicros( void );
+  unsigned long ulHostMonotonicNanos( void );
+
+  /* Server period and budget of the current run, in ticks. */
+  extern unsigned long ulSimulatorServerPeriod;
+  extern unsigned long ulSimulatorServerBudget;
+#ifdef __cplusplus
+}
+#endif
+
+#define configASSERT( x ) if( ( x ) == 0 ) vHostAssertCalled( __FILE__, __LINE__ )
+
+#define traceTASK_SWITCHED_IN() vSchedulerTraceTaskSwitchedIn()
+#define traceTASK_SWITCHED_OUT() vSchedulerTraceTaskSwitchedOut()
+
+/* schedREAD_MICROS() keeps its default, micros(), which follows the virtual
+ * tick count, so runs are reproducible with schedUSE_SUBTICK_ACCOUNTING too. */
+
+#define POLLING_SERVER_PERIOD ( ( TickType_t ) ulSimulatorServerPeriod )
+#define POLLING_SERVER_MAX_EXEC_TIME ( ( TickType_t ) ulSimulatorServerBudget )
+
+/* The scheduler overhead is measured in nanoseconds of host time. */
+#define schedREAD_OVERHEAD_CLOCK() ulHostMonotonicNanos()
+
+#endif /* FREERTOS_CONFIG_H */
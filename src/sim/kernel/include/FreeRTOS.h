@@ -0,0 +1,34 @@
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+/* Headers of the stand-in kernel of the simulator, see tasks.c. A subset of
+ * those of FreeRTOS 10.4, with the same API. */
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOSConfig.h"
+#include "projdefs.h"
+#include "portable.h"
+#ifndef configASSERT
+  #define configASSERT( x )
+#endif
+#ifndef configSTACK_DEPTH_TYPE
+  #define configSTACK_DEPTH_TYPE uint16_t
+#endif
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+  #define configTASK_NOTIFICATION_ARRAY_ENTRIES 1
+#endif
+#ifndef configUSE_TIME_SLICING
+  #define configUSE_TIME_SLICING 1
+#endif
+#ifndef traceTASK_SWITCHED_IN
+  #define traceTASK_SWITCHED_IN()
+#endif
+#ifndef traceTASK_SWITCHED_OUT
+  #define traceTASK_SWITCHED_OUT()
+#endif
+typedef struct xSTATIC_TCB
+{
+  void *pxDummy[ 24 + configNUM_THREAD_LOCAL_STORAGE_POINTERS + 2 * configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+  char ucDummy[ configMAX_TASK_NAME_LEN ];
+} StaticTask_t;
+typedef struct xSTATIC_TIMER { void *pvDummy[ 12 ]; } StaticTimer_t;
+#endif
@@ -0,0 +1,2 @@
+/* Part of the stand-in kernel of the simulator, see tasks.c. Included by
+ * scheduler.h, which uses nothing of it. */
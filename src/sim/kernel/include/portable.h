@@ -0,0 +1,22 @@
+#ifndef PORTABLE_H
+#define PORTABLE_H
+#include "portmacro.h"
+#if portBYTE_ALIGNMENT == 16
+  #define portBYTE_ALIGNMENT_MASK ( 0x000f )
+#elif portBYTE_ALIGNMENT == 8
+  #define portBYTE_ALIGNMENT_MASK ( 0x0007 )
+#else
+  #define portBYTE_ALIGNMENT_MASK ( 0x0001 )
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters );
+BaseType_t xPortStartScheduler( void );
+void vPortEndScheduler( void );
+void *pvPortMalloc( size_t xSize );
+void vPortFree( void *pv );
+#ifdef __cplusplus
+}
+#endif
+#endif
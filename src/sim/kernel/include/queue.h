@@ -0,0 +1,6 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+#include "FreeRTOS.h"
+struct QueueDefinition;
+typedef struct QueueDefinition *QueueHandle_t;
+#endif
@@ -0,0 +1,5 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+#include "queue.h"
+typedef QueueHandle_t SemaphoreHandle_t;
+#endif
@@ -0,0 +1,7 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+#include "task.h"
+struct tmrTimerControl;
+typedef struct tmrTimerControl *TimerHandle_t;
+typedef void ( *TimerCallbackFunction_t )( TimerHandle_t xTimer );
+#endif
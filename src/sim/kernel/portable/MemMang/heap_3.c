@@ -0,0 +1,7 @@
+/* Heap of the stand-in kernel of the simulator, on malloc() like the
+ * heap_3.c of FreeRTOS. */
+
+#include <stdlib.h>
+#include "FreeRTOS.h"
+void *pvPortMalloc( size_t xSize ) { return malloc( xSize ); }
+void vPortFree( void *pv ) { free( pv ); }
@@ -0,0 +1,3 @@
+/* Part of the stand-in kernel of the simulator, see tasks.c. The scheduler
+ * does not use it, the file only lets the stand-in build with the same
+ * commands as the FreeRTOS-Kernel sources. */
@@ -0,0 +1,808 @@
+/* Stand-in kernel of the simulator, in place of FreeRTOS tasks.c. It only
+ * implements the part of the task API that the scheduler and the simulator
+ * use, on one core, fixed priority preemptive with time slicing, and runs on
+ * the port of src/sim. Its semantics follow FreeRTOS 10.4: ready lists with
+ * a round robin index, one delayed list, ticks pended while the scheduler is
+ * suspended, the tick hook called even then, and deleted tasks freed by the
+ * idle task. The results quoted in README.md were measured with it. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define tskREADY 0
+#define tskDELAYED 1
+#define tskSUSPENDED 2
+#define tskDELETED 3
+
+#define tskNOT_WAITING 0
+#define tskWAITING 1
+#define tskRECEIVED 2
+
+typedef struct tskNode
+{
+  struct tskTaskControlBlock *pxOwner;
+  struct tskNode *pxNext;
+  struct tskNode *pxPrev;
+} Node_t;
+
+typedef struct tskList
+{
+  Node_t xEnd;
+  Node_t *pxIndex;
+  UBaseType_t uxCount;
+} List_t;
+
+typedef struct tskTaskControlBlock
+{
+  volatile StackType_t *pxTopOfStack;
+  Node_t xStateNode;
+  List_t *pxContainer;
+  TickType_t xWakeTime;
+  UBaseType_t uxPriority;
+  int iState;
+  StackType_t *pxStack;
+  BaseType_t xStaticTCB;
+  BaseType_t xStaticStack;
+  void *pvTLS[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
+  uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+  uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+  char pcTaskName[ configMAX_TASK_NAME_LEN ];
+} TCB_t;
+
+typedef char prvStaticTaskFits[ ( sizeof( TCB_t ) <= sizeof( StaticTask_t ) ) ? 1 : -1 ];
+
+static List_t pxReadyTasksLists[ configMAX_PRIORITIES ];
+static List_t xDelayedTaskList;
+static List_t xTasksWaitingTermination;
+static TCB_t * volatile pxCurrentTCB = NULL;
+static TCB_t *pxIdleTCB = NULL;
+static volatile TickType_t xTickCount = 0;
+static volatile UBaseType_t uxSchedulerSuspended = 0;
+static volatile TickType_t xPendedTicks = 0;
+static volatile BaseType_t xYieldPending = pdFALSE;
+static volatile BaseType_t xSchedulerRunning = pdFALSE;
+static UBaseType_t uxTopReadyPriority = 0;
+static BaseType_t xListsInitialised = pdFALSE;
+
+extern void vApplicationIdleHook( void );
+extern void vApplicationTickHook( void );
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+  extern void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize );
+#endif
+
+static void prvListInit( List_t *pxList )
+{
+  pxList->xEnd.pxOwner = NULL;
+  pxList->xEnd.pxNext = &pxList->xEnd;
+  pxList->xEnd.pxPrev = &pxList->xEnd;
+  pxList->pxIndex = &pxList->xEnd;
+  pxList->uxCount = 0;
+}
+
+static void prvInitLists( void )
+{
+  UBaseType_t uxPriority;
+
+  if( pdFALSE != xListsInitialised )
+  {
+    return;
+  }
+  for( uxPriority = 0; uxPriority < configMAX_PRIORITIES; uxPriority++ )
+  {
+    prvListInit( &pxReadyTasksLists[ uxPriority ] );
+  }
+  prvListInit( &xDelayedTaskList );
+  prvListInit( &xTasksWaitingTermination );
+  xListsInitialised = pdTRUE;
+}
+
+/* Inserts before the index, so the task is the last one to be selected. */
+static void prvListInsertEnd( List_t *pxList, TCB_t *pxTCB )
+{
+  Node_t *pxNode = &pxTCB->xStateNode;
+  Node_t *pxIndex = pxList->pxIndex;
+
+  pxNode->pxNext = pxIndex;
+  pxNode->pxPrev = pxIndex->pxPrev;
+  pxIndex->pxPrev->pxNext = pxNode;
+  pxIndex->pxPrev = pxNode;
+  pxTCB->pxContainer = pxList;
+  pxList->uxCount++;
+}
+
+static void prvListRemove( TCB_t *pxTCB )
+{
+  Node_t *pxNode = &pxTCB->xStateNode;
+  List_t *pxList = pxTCB->pxContainer;
+
+  if( NULL == pxList )
+  {
+    return;
+  }
+  pxNode->pxNext->pxPrev = pxNode->pxPrev;
+  pxNode->pxPrev->pxNext = pxNode->pxNext;
+  if( pxList->pxIndex == pxNode )
+  {
+    pxList->pxIndex = pxNode->pxPrev;
+  }
+  pxTCB->pxContainer = NULL;
+  pxList->uxCount--;
+}
+
+static void prvAddToReady( TCB_t *pxTCB )
+{
+  pxTCB->iState = tskREADY;
+  if( pxTCB->uxPriority > uxTopReadyPriority )
+  {
+    uxTopReadyPriority = pxTCB->uxPriority;
+  }
+  prvListInsertEnd( &pxReadyTasksLists[ pxTCB->uxPriority ], pxTCB );
+}
+
+/* Keeps the delayed list sorted by wake time, tasks with the same wake time
+ * in insertion order. No tick overflow within a run is assumed. */
+static void prvAddToDelayed( TCB_t *pxTCB, TickType_t xWakeTime )
+{
+  Node_t *pxPos = xDelayedTaskList.xEnd.pxNext;
+  Node_t *pxNode = &pxTCB->xStateNode;
+
+  pxTCB->iState = tskDELAYED;
+  pxTCB->xWakeTime = xWakeTime;
+  while( pxPos != &xDelayedTaskList.xEnd && pxPos->pxOwner->xWakeTime <= xWakeTime )
+  {
+    pxPos = pxPos->pxNext;
+  }
+  pxNode->pxNext = pxPos;
+  pxNode->pxPrev = pxPos->pxPrev;
+  pxPos->pxPrev->pxNext = pxNode;
+  pxPos->pxPrev = pxNode;
+  pxTCB->pxContainer = &xDelayedTaskList;
+  xDelayedTaskList.uxCount++;
+}
+
+/* Blocks the current task, for ever with portMAX_DELAY. */
+static void prvBlockCurrent( TickType_t xTicksToWait )
+{
+  prvListRemove( pxCurrentTCB );
+  if( portMAX_DELAY == xTicksToWait )
+  {
+    pxCurrentTCB->iState = tskSUSPENDED;
+  }
+  else
+  {
+    prvAddToDelayed( pxCurrentTCB, xTickCount + xTicksToWait );
+  }
+}
+
+static TCB_t *prvGetTCB( TaskHandle_t xTask )
+{
+  return ( NULL == xTask ) ? pxCurrentTCB : xTask;
+}
+
+static void prvYieldIfHigher( TCB_t *pxTCB )
+{
+  if( pdFALSE != xSchedulerRunning && pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+  {
+    portYIELD();
+  }
+}
+
+static void prvIdleTask( void *pvParameters );
+
+static TCB_t *prvInitTask( TaskFunction_t pxTaskCode, const char * const pcName, uint32_t ulStackDepth, void * const pvParameters,
+                           UBaseType_t uxPriority, StackType_t *pxStack, TCB_t *pxTCB )
+{
+  StackType_t *pxTopOfStack;
+
+  prvInitLists();
+  memset( pxTCB, 0, sizeof( TCB_t ) );
+  pxTCB->xStateNode.pxOwner = pxTCB;
+  pxTCB->pxStack = pxStack;
+  if( uxPriority >= configMAX_PRIORITIES )
+  {
+    uxPriority = configMAX_PRIORITIES - 1;
+  }
+  pxTCB->uxPriority = uxPriority;
+  strncpy( pxTCB->pcTaskName, ( NULL != pcName ) ? pcName : "", configMAX_TASK_NAME_LEN - 1 );
+
+  pxTopOfStack = pxStack + ( ulStackDepth - 1 );
+  pxTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxStack, pxTaskCode, pvParameters );
+
+  taskENTER_CRITICAL();
+  if( NULL == pxCurrentTCB )
+  {
+    pxCurrentTCB = pxTCB;
+  }
+  else if( pdFALSE == xSchedulerRunning && pxCurrentTCB->uxPriority <= uxPriority )
+  {
+    pxCurrentTCB = pxTCB;
+  }
+  prvAddToReady( pxTCB );
+  taskEXIT_CRITICAL();
+
+  prvYieldIfHigher( pxTCB );
+  return pxTCB;
+}
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters,
+                        UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+  StackType_t *pxStack = ( StackType_t * ) pvPortMalloc( ( size_t ) usStackDepth * sizeof( StackType_t ) );
+  TCB_t *pxTCB;
+
+  if( NULL == pxStack )
+  {
+    return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+  }
+  pxTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+  if( NULL == pxTCB )
+  {
+    vPortFree( pxStack );
+    return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+  }
+  if( NULL != pxCreatedTask )
+  {
+    *pxCreatedTask = pxTCB;
+  }
+  prvInitTask( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxStack, pxTCB );
+  return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStatic( TaskFunction_t pxTaskCode, const char * const pcName, const uint32_t ulStackDepth, void * const pvParameters,
+                                UBaseType_t uxPriority, StackType_t * const puxStackBuffer, StaticTask_t * const pxTaskBuffer )
+{
+  TCB_t *pxTCB = ( TCB_t * ) pxTaskBuffer;
+
+  if( NULL == puxStackBuffer || NULL == pxTaskBuffer )
+  {
+    return NULL;
+  }
+  prvInitTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, puxStackBuffer, pxTCB );
+  pxTCB->xStaticTCB = pdTRUE;
+  pxTCB->xStaticStack = pdTRUE;
+  return pxTCB;
+}
+
+static void prvFreeTCB( TCB_t *pxTCB )
+{
+  if( pdFALSE == pxTCB->xStaticStack )
+  {
+    vPortFree( pxTCB->pxStack );
+  }
+  if( pdFALSE == pxTCB->xStaticTCB )
+  {
+    vPortFree( pxTCB );
+  }
+}
+
+void vTaskDelete( TaskHandle_t xTaskToDelete )
+{
+  TCB_t *pxTCB;
+
+  taskENTER_CRITICAL();
+  pxTCB = prvGetTCB( xTaskToDelete );
+  prvListRemove( pxTCB );
+  pxTCB->iState = tskDELETED;
+  if( pxTCB == pxCurrentTCB )
+  {
+    prvListInsertEnd( &xTasksWaitingTermination, pxTCB );
+  }
+  taskEXIT_CRITICAL();
+
+  if( pxTCB != pxCurrentTCB )
+  {
+    prvFreeTCB( pxTCB );
+  }
+  else if( pdFALSE != xSchedulerRunning )
+  {
+    configASSERT( 0 == uxSchedulerSuspended );
+    portYIELD();
+  }
+}
+
+void vTaskDelay( const TickType_t xTicksToDelay )
+{
+  if( xTicksToDelay > 0 )
+  {
+    vTaskSuspendAll();
+    prvBlockCurrent( xTicksToDelay );
+    if( pdFALSE != xTaskResumeAll() )
+    {
+      return;
+    }
+  }
+  portYIELD();
+}
+
+void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement )
+{
+  TickType_t xTimeToWake;
+  BaseType_t xShouldDelay = pdFALSE;
+  const TickType_t xConstTickCount = xTickCount;
+
+  vTaskSuspendAll();
+  xTimeToWake = *pxPreviousWakeTime + xTimeIncrement;
+  if( xConstTickCount < *pxPreviousWakeTime )
+  {
+    if( xTimeToWake < *pxPreviousWakeTime && xTimeToWake > xConstTickCount )
+    {
+      xShouldDelay = pdTRUE;
+    }
+  }
+  else if( xTimeToWake < *pxPreviousWakeTime || xTimeToWake > xConstTickCount )
+  {
+    xShouldDelay = pdTRUE;
+  }
+  *pxPreviousWakeTime = xTimeToWake;
+  if( pdFALSE != xShouldDelay )
+  {
+    prvBlockCurrent( xTimeToWake - xConstTickCount );
+  }
+  if( pdFALSE == xTaskResumeAll() )
+  {
+    portYIELD();
+  }
+}
+
+UBaseType_t uxTaskPriorityGet( const TaskHandle_t xTask )
+{
+  return prvGetTCB( xTask )->uxPriority;
+}
+
+void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority )
+{
+  TCB_t *pxTCB;
+  BaseType_t xYieldRequired = pdFALSE;
+
+  if( uxNewPriority >= configMAX_PRIORITIES )
+  {
+    uxNewPriority = configMAX_PRIORITIES - 1;
+  }
+
+  taskENTER_CRITICAL();
+  pxTCB = prvGetTCB( xTask );
+  if( pxTCB->uxPriority != uxNewPriority )
+  {
+    if( uxNewPriority > pxTCB->uxPriority )
+    {
+      if( pxTCB != pxCurrentTCB && uxNewPriority > pxCurrentTCB->uxPriority )
+      {
+        xYieldRequired = pdTRUE;
+      }
+    }
+    else if( pxTCB == pxCurrentTCB )
+    {
+      xYieldRequired = pdTRUE;
+    }
+
+    if( tskREADY == pxTCB->iState )
+    {
+      prvListRemove( pxTCB );
+      pxTCB->uxPriority = uxNewPriority;
+      prvAddToReady( pxTCB );
+    }
+    else
+    {
+      pxTCB->uxPriority = uxNewPriority;
+    }
+  }
+  taskEXIT_CRITICAL();
+
+  if( pdFALSE != xYieldRequired && pdFALSE != xSchedulerRunning )
+  {
+    portYIELD();
+  }
+}
+
+/* A task blocked on a notification is not suspended, as in FreeRTOS 10.4.4
+ * and later. */
+static BaseType_t prvIsSuspended( TCB_t *pxTCB )
+{
+  UBaseType_t uxIndex;
+
+  if( tskSUSPENDED != pxTCB->iState )
+  {
+    return pdFALSE;
+  }
+  for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+  {
+    if( tskWAITING == pxTCB->ucNotifyState[ uxIndex ] )
+    {
+      return pdFALSE;
+    }
+  }
+  return pdTRUE;
+}
+
+void vTaskSuspend( TaskHandle_t xTaskToSuspend )
+{
+  TCB_t *pxTCB;
+  UBaseType_t uxIndex;
+
+  taskENTER_CRITICAL();
+  pxTCB = prvGetTCB( xTaskToSuspend );
+  prvListRemove( pxTCB );
+  pxTCB->iState = tskSUSPENDED;
+  for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+  {
+    if( tskWAITING == pxTCB->ucNotifyState[ uxIndex ] )
+    {
+      pxTCB->ucNotifyState[ uxIndex ] = tskNOT_WAITING;
+    }
+  }
+  taskEXIT_CRITICAL();
+
+  if( pxTCB == pxCurrentTCB && pdFALSE != xSchedulerRunning )
+  {
+    configASSERT( 0 == uxSchedulerSuspended );
+    portYIELD();
+  }
+}
+
+void vTaskResume( TaskHandle_t xTaskToResume )
+{
+  TCB_t *pxTCB = xTaskToResume;
+
+  if( NULL == pxTCB || pxTCB == pxCurrentTCB )
+  {
+    return;
+  }
+  taskENTER_CRITICAL();
+  if( pdFALSE != prvIsSuspended( pxTCB ) )
+  {
+    prvAddToReady( pxTCB );
+    taskEXIT_CRITICAL();
+    prvYieldIfHigher( pxTCB );
+    return;
+  }
+  taskEXIT_CRITICAL();
+}
+
+BaseType_t xTaskResumeFromISR( TaskHandle_t xTaskToResume )
+{
+  TCB_t *pxTCB = xTaskToResume;
+  BaseType_t xYieldRequired = pdFALSE;
+
+  if( pdFALSE != prvIsSuspended( pxTCB ) )
+  {
+    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+    {
+      xYieldRequired = pdTRUE;
+      xYieldPending = pdTRUE;
+    }
+    prvAddToReady( pxTCB );
+  }
+  return xYieldRequired;
+}
+
+static void prvIdleTask( void *pvParameters )
+{
+  ( void ) pvParameters;
+
+  for( ;; )
+  {
+    while( xTasksWaitingTermination.uxCount > 0 )
+    {
+      TCB_t *pxTCB;
+
+      taskENTER_CRITICAL();
+      pxTCB = xTasksWaitingTermination.xEnd.pxNext->pxOwner;
+      prvListRemove( pxTCB );
+      taskEXIT_CRITICAL();
+      prvFreeTCB( pxTCB );
+    }
+
+    if( pxReadyTasksLists[ tskIDLE_PRIORITY ].uxCount > 1 )
+    {
+      taskYIELD();
+    }
+
+    vApplicationIdleHook();
+  }
+}
+
+void vTaskStartScheduler( void )
+{
+  #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+    StaticTask_t *pxIdleTaskTCBBuffer = NULL;
+    StackType_t *pxIdleTaskStackBuffer = NULL;
+    uint32_t ulIdleTaskStackSize;
+
+    vApplicationGetIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
+    pxIdleTCB = xTaskCreateStatic( prvIdleTask, "IDLE", ulIdleTaskStackSize, NULL, tskIDLE_PRIORITY, pxIdleTaskStackBuffer, pxIdleTaskTCBBuffer );
+    if( NULL == pxIdleTCB )
+    {
+      return;
+    }
+  #else
+    if( pdPASS != xTaskCreate( prvIdleTask, "IDLE", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, &pxIdleTCB ) )
+    {
+      return;
+    }
+  #endif
+
+  portDISABLE_INTERRUPTS();
+  xTickCount = 0;
+  xSchedulerRunning = pdTRUE;
+  traceTASK_SWITCHED_IN();
+  ( void ) xPortStartScheduler();
+}
+
+void vTaskEndScheduler( void )
+{
+  xSchedulerRunning = pdFALSE;
+  vPortEndScheduler();
+}
+
+void vTaskSuspendAll( void )
+{
+  uxSchedulerSuspended++;
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+  BaseType_t xAlreadyYielded = pdFALSE;
+
+  configASSERT( uxSchedulerSuspended > 0 );
+  taskENTER_CRITICAL();
+  uxSchedulerSuspended--;
+  if( 0 == uxSchedulerSuspended )
+  {
+    TickType_t xPendedCounts = xPendedTicks;
+
+    while( xPendedCounts > 0 )
+    {
+      if( pdFALSE != xTaskIncrementTick() )
+      {
+        xYieldPending = pdTRUE;
+      }
+      xPendedCounts--;
+    }
+    xPendedTicks = 0;
+
+    if( pdFALSE != xYieldPending && pdFALSE != xSchedulerRunning )
+    {
+      xAlreadyYielded = pdTRUE;
+      taskEXIT_CRITICAL();
+      portYIELD();
+      return xAlreadyYielded;
+    }
+  }
+  taskEXIT_CRITICAL();
+  return xAlreadyYielded;
+}
+
+TickType_t xTaskGetTickCount( void )
+{
+  return xTickCount;
+}
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+  return xTickCount;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+  return pxCurrentTCB;
+}
+
+TaskHandle_t xTaskGetIdleTaskHandle( void )
+{
+  return pxIdleTCB;
+}
+
+char *pcTaskGetName( TaskHandle_t xTaskToQuery )
+{
+  return prvGetTCB( xTaskToQuery )->pcTaskName;
+}
+
+void vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue )
+{
+  if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
+  {
+    prvGetTCB( xTaskToSet )->pvTLS[ xIndex ] = pvValue;
+  }
+}
+
+void *pvTaskGetThreadLocalStoragePointer( TaskHandle_t xTaskToQuery, BaseType_t xIndex )
+{
+  if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
+  {
+    return prvGetTCB( xTaskToQuery )->pvTLS[ xIndex ];
+  }
+  return NULL;
+}
+
+/* Unblocks a task that waits for a notification. */
+static void prvNotifyUnblock( TCB_t *pxTCB )
+{
+  prvListRemove( pxTCB );
+  prvAddToReady( pxTCB );
+}
+
+BaseType_t xTaskGenericNotifyGive( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify )
+{
+  TCB_t *pxTCB = xTaskToNotify;
+  uint8_t ucOriginalState;
+
+  configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+  taskENTER_CRITICAL();
+  ucOriginalState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+  pxTCB->ucNotifyState[ uxIndexToNotify ] = tskRECEIVED;
+  pxTCB->ulNotifiedValue[ uxIndexToNotify ]++;
+  if( tskWAITING == ucOriginalState )
+  {
+    prvNotifyUnblock( pxTCB );
+    taskEXIT_CRITICAL();
+    prvYieldIfHigher( pxTCB );
+    return pdPASS;
+  }
+  taskEXIT_CRITICAL();
+  return pdPASS;
+}
+
+void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+{
+  TCB_t *pxTCB = xTaskToNotify;
+  uint8_t ucOriginalState;
+
+  configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+  ucOriginalState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+  pxTCB->ucNotifyState[ uxIndexToNotify ] = tskRECEIVED;
+  pxTCB->ulNotifiedValue[ uxIndexToNotify ]++;
+  if( tskWAITING == ucOriginalState )
+  {
+    prvNotifyUnblock( pxTCB );
+    if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+    {
+      if( NULL != pxHigherPriorityTaskWoken )
+      {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+      }
+      xYieldPending = pdTRUE;
+    }
+  }
+}
+
+uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+  uint32_t ulReturn;
+
+  configASSERT( uxIndexToWaitOn < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+  taskENTER_CRITICAL();
+  if( 0 == pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] )
+  {
+    pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] = tskWAITING;
+    if( xTicksToWait > 0 )
+    {
+      prvBlockCurrent( xTicksToWait );
+      taskEXIT_CRITICAL();
+      portYIELD();
+      taskENTER_CRITICAL();
+    }
+  }
+  ulReturn = pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ];
+  if( 0 != ulReturn )
+  {
+    if( pdFALSE != xClearCountOnExit )
+    {
+      pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] = 0;
+    }
+    else
+    {
+      pxCurrentTCB->ulNotifiedValue[ uxIndexToWaitOn ] = ulReturn - 1;
+    }
+  }
+  pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] = tskNOT_WAITING;
+  taskEXIT_CRITICAL();
+  return ulReturn;
+}
+
+BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear )
+{
+  TCB_t *pxTCB = prvGetTCB( xTask );
+  BaseType_t xReturn = pdFAIL;
+
+  taskENTER_CRITICAL();
+  if( tskRECEIVED == pxTCB->ucNotifyState[ uxIndexToClear ] )
+  {
+    pxTCB->ucNotifyState[ uxIndexToClear ] = tskNOT_WAITING;
+    xReturn = pdPASS;
+  }
+  taskEXIT_CRITICAL();
+  return xReturn;
+}
+
+BaseType_t xTaskIncrementTick( void )
+{
+  BaseType_t xSwitchRequired = pdFALSE;
+
+  if( 0 == uxSchedulerSuspended )
+  {
+    const TickType_t xConstTickCount = xTickCount + 1;
+
+    xTickCount = xConstTickCount;
+    while( xDelayedTaskList.uxCount > 0 )
+    {
+      TCB_t *pxTCB = xDelayedTaskList.xEnd.pxNext->pxOwner;
+      UBaseType_t uxIndex;
+
+      if( pxTCB->xWakeTime > xConstTickCount )
+      {
+        break;
+      }
+      prvListRemove( pxTCB );
+      for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+      {
+        if( tskWAITING == pxTCB->ucNotifyState[ uxIndex ] )
+        {
+          pxTCB->ucNotifyState[ uxIndex ] = tskNOT_WAITING;
+        }
+      }
+      prvAddToReady( pxTCB );
+      if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+      {
+        xSwitchRequired = pdTRUE;
+      }
+    }
+
+    #if( configUSE_TIME_SLICING == 1 )
+      if( pxReadyTasksLists[ pxCurrentTCB->uxPriority ].uxCount > 1 )
+      {
+        xSwitchRequired = pdTRUE;
+      }
+    #endif
+
+    if( 0 == xPendedTicks )
+    {
+      vApplicationTickHook();
+    }
+  }
+  else
+  {
+    xPendedTicks++;
+    vApplicationTickHook();
+  }
+
+  if( pdFALSE != xYieldPending )
+  {
+    xSwitchRequired = pdTRUE;
+  }
+  return xSwitchRequired;
+}
+
+void vTaskSwitchContext( void )
+{
+  UBaseType_t uxTopPriority;
+  List_t *pxList;
+
+  if( 0 != uxSchedulerSuspended )
+  {
+    xYieldPending = pdTRUE;
+    return;
+  }
+  xYieldPending = pdFALSE;
+  traceTASK_SWITCHED_OUT();
+
+  uxTopPriority = uxTopReadyPriority;
+  while( 0 == pxReadyTasksLists[ uxTopPriority ].uxCount )
+  {
+    configASSERT( uxTopPriority > 0 );
+    uxTopPriority--;
+  }
+  uxTopReadyPriority = uxTopPriority;
+
+  pxList = &pxReadyTasksLists[ uxTopPriority ];
+  pxList->pxIndex = pxList->pxIndex->pxNext;
+  if( pxList->pxIndex == &pxList->xEnd )
+  {
+    pxList->pxIndex = pxList->pxIndex->pxNext;
+  }
+  pxCurrentTCB = pxList->pxIndex->pxOwner;
+
+  traceTASK_SWITCHED_IN();
+}
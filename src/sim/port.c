@@ -0,0 +1,156 @@
+/* FreeRTOS port for the scheduling simulator, see portmacro.h. */
+
+#include <stdint.h>
+#include <ucontext.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Execution context of a task. It is kept at the top of the task stack, and
+ * the TCB's pxTopOfStack points to it. */
+typedef struct simThread
+{
+  ucontext_t xContext;
+  TaskFunction_t pxCode;
+  void *pvParameters;
+  UBaseType_t uxCriticalNesting;
+} SimThread_t;
+
+/* Context of vTaskStartScheduler(), resumed by vPortEndScheduler(). */
+static ucontext_t xStartContext;
+
+static UBaseType_t uxCriticalNesting = 0;
+static BaseType_t xInTick = pdFALSE;
+static BaseType_t xSwitchPending = pdFALSE;
+
+static SimThread_t *prvGetThread( TaskHandle_t xTask )
+{
+  /* pxTopOfStack is the first member of the TCB. */
+  return *( SimThread_t * volatile * ) xTask;
+}
+
+static void prvTaskEntry( void )
+{
+  SimThread_t *pxThread = prvGetThread( xTaskGetCurrentTaskHandle() );
+
+  pxThread->pxCode( pxThread->pvParameters );
+
+  /* Tasks must not return. */
+  vTaskDelete( NULL );
+}
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+  SimThread_t *pxThread;
+  uintptr_t uxThread;
+
+  uxThread = ( ( uintptr_t ) ( pxTopOfStack + 1 ) - sizeof( SimThread_t ) ) & ~( uintptr_t ) portBYTE_ALIGNMENT_MASK;
+  pxThread = ( SimThread_t * ) uxThread;
+  configASSERT( uxThread > ( uintptr_t ) pxEndOfStack );
+
+  pxThread->pxCode = pxCode;
+  pxThread->pvParameters = pvParameters;
+  pxThread->uxCriticalNesting = 0;
+
+  getcontext( &pxThread->xContext );
+  pxThread->xContext.uc_stack.ss_sp = pxEndOfStack;
+  pxThread->xContext.uc_stack.ss_size = uxThread - ( uintptr_t ) pxEndOfStack;
+  pxThread->xContext.uc_link = NULL;
+  makecontext( &pxThread->xContext, prvTaskEntry, 0 );
+
+  return ( StackType_t * ) pxThread;
+}
+
+/* Selects the next task and switches to it. The calling task continues here
+ * when it is selected again. */
+static void prvSwitchContext( void )
+{
+  SimThread_t *pxPrevious = prvGetThread( xTaskGetCurrentTaskHandle() );
+  SimThread_t *pxNext;
+
+  vTaskSwitchContext();
+  pxNext = prvGetThread( xTaskGetCurrentTaskHandle() );
+  if( pxNext != pxPrevious )
+  {
+    pxPrevious->uxCriticalNesting = uxCriticalNesting;
+    uxCriticalNesting = pxNext->uxCriticalNesting;
+    swapcontext( &pxPrevious->xContext, &pxNext->xContext );
+  }
+}
+
+void vPortYield( void )
+{
+  prvSwitchContext();
+}
+
+void vPortYieldFromISR( BaseType_t xSwitchRequired )
+{
+  if( pdFALSE != xSwitchRequired )
+  {
+    /* Inside the tick, the switch is done once the tick is complete. */
+    if( pdFALSE != xInTick )
+    {
+      xSwitchPending = pdTRUE;
+    }
+    else
+    {
+      prvSwitchContext();
+    }
+  }
+}
+
+void vPortEnterCritical( void )
+{
+  uxCriticalNesting++;
+}
+
+void vPortExitCritical( void )
+{
+  configASSERT( uxCriticalNesting > 0 );
+  uxCriticalNesting--;
+}
+
+static void prvTick( void )
+{
+  BaseType_t xSwitchRequired;
+
+  xInTick = pdTRUE;
+  xSwitchRequired = xTaskIncrementTick();
+  if( pdFALSE != xPortSimulatorTickHook() )
+  {
+    xSwitchRequired = pdTRUE;
+  }
+  xInTick = pdFALSE;
+
+  if( pdFALSE != xSwitchRequired || pdFALSE != xSwitchPending )
+  {
+    xSwitchPending = pdFALSE;
+    prvSwitchContext();
+  }
+}
+
+void vPortSimulatorExecute( TickType_t xTicks )
+{
+  configASSERT( 0 == uxCriticalNesting );
+
+  while( xTicks-- > 0 )
+  {
+    prvTick();
+  }
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+  SimThread_t *pxFirst = prvGetThread( xTaskGetCurrentTaskHandle() );
+
+  uxCriticalNesting = pxFirst->uxCriticalNesting;
+  swapcontext( &xStartContext, &pxFirst->xContext );
+
+  /* Only reached through vPortEndScheduler(). */
+  return pdFALSE;
+}
+
+void vPortEndScheduler( void )
+{
+  setcontext( &xStartContext );
+}
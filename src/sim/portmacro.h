@@ -0,0 +1,85 @@
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+/* FreeRTOS port for the scheduling simulator (tools/schedSimulator.cpp).
+ * Tasks are ucontext coroutines on a single host thread, and time is
+ * virtual: a tick only passes when a task calls vPortSimulatorExecute(),
+ * which stands for the task using the processor for that many ticks. The
+ * idle task advances time the same way through the idle hook. Interrupts do
+ * not exist, so everything is deterministic and runs as fast as the host
+ * can switch contexts. */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+#define portSTACK_TYPE unsigned long
+#define portBASE_TYPE long
+#define portPOINTER_SIZE_TYPE size_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if( configUSE_16_BIT_TICKS == 1 )
+  typedef uint16_t TickType_t;
+  #define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+  typedef uint32_t TickType_t;
+  #define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#endif
+#define portTICK_TYPE_IS_ATOMIC 1
+
+#define portSTACK_GROWTH ( -1 )
+#define portTICK_PERIOD_MS ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT 16
+#define portNOP()
+
+/* pxPortInitialiseStack() needs the end of the stack for makecontext(). */
+#define portHAS_STACK_OVERFLOW_CHECKING 1
+
+void vPortYield( void );
+void vPortYieldFromISR( BaseType_t xSwitchRequired );
+void vPortEnterCritical( void );
+void vPortExitCritical( void );
+
+#define portYIELD() vPortYield()
+#define portYIELD_FROM_ISR( x ) vPortYieldFromISR( x )
+#define portEND_SWITCHING_ISR( x ) vPortYieldFromISR( x )
+
+/* Nothing can interrupt a task, only the nesting of critical sections is
+ * kept, per task, as the AVR port keeps the interrupt flag. */
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portSET_INTERRUPT_MASK_FROM_ISR() 0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x ) ( void ) ( x )
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+
+/* Lets the calling task execute for xTicks ticks of virtual time. The tick
+ * interrupt is delivered at the end of every tick, so the task can be
+ * preempted, suspended or deleted inside. Must not be called from a critical
+ * section. */
+void vPortSimulatorExecute( TickType_t xTicks );
+
+/* Called at every tick after xTaskIncrementTick(), from the tick
+ * "interrupt". Provided by the simulator, returns pdTRUE if a context switch
+ * is needed. This is where the simulator injects external events. */
+BaseType_t xPortSimulatorTickHook( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
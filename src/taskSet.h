@@ -0,0 +1,22 @@
+#ifndef TASK_SET_H_
+#define TASK_SET_H_
+
+/* Task set of pollingServer.ino when built with schedUSE_STATIC_TASK_SET,
+ * see schedTaskSet.h. The tasks are those that main() creates otherwise,
+ * with budgets that the analysis accepts: main() gives both tasks 200 ms,
+ * which with the polling server is more than 100 % of the processor. */
+
+void testFunc1( void *pvParameters );
+void testFunc2( void *pvParameters );
+
+extern TaskHandle_t xHandle1;
+extern TaskHandle_t xHandle2;
+
+static constexpr SchedTaskSpec_t xSchedTaskSet[] =
+{
+  /* pvTaskCode, pcName, uxStackDepth, pvParameters, pxCreatedTask, xPhaseTick, xPeriodTick, xMaxExecTimeTick, xDeadlineTick */
+  { testFunc1, "t1", configMINIMAL_STACK_SIZE, NULL, &xHandle1, pdMS_TO_TICKS( 0 ), pdMS_TO_TICKS( 800 ), pdMS_TO_TICKS( 100 ), pdMS_TO_TICKS( 800 ) },
+  { testFunc2, "t2", configMINIMAL_STACK_SIZE, NULL, &xHandle2, pdMS_TO_TICKS( 0 ), pdMS_TO_TICKS( 400 ), pdMS_TO_TICKS( 100 ), pdMS_TO_TICKS( 400 ) },
+};
+
+#endif /* TASK_SET_H_ */
@@ -0,0 +1,688 @@
+/* Schedulability and overhead benchmark of the scheduler. Generates random
+ * periodic task sets at a range of utilizations, runs every set through
+ * schedSimulator (see tools/schedSimulator.cpp) and prints one CSV line per
+ * utilization. With -b, the result is compared with a stored baseline, and
+ * the exit status is 2 if it is worse.
+ *
+ * Usage: schedBenchmark [-u from:to:step] [-m sets] [-n min:max] [-T min:max]
+ *                       [-c fraction] [-S period:budget] [-d ticks] [-s seed]
+ *                       [-j jobs] [-p simulator] [-b baseline] [-r percent]
+ *                       [-- simulator options]
+ *
+ *   -u  Total utilizations of the sets, 0.5:0.95:0.05 by default. The
+ *       server utilization is included.
+ *   -m  Sets per utilization, 20 by default.
+ *   -n  Number of periodic tasks of a set, uniform in [min,max], 2:6 by
+ *       default. max must not exceed what schedSimulator -L prints.
+ *   -T  Periods in ticks, log-uniform in [min,max], 10:1000 by default.
+ *       Deadlines are equal to the periods.
+ *   -c  Jobs execute uniformly between fraction times their longest
+ *       execution time and the longest execution time, 1 by default. The
+ *       longest execution time is one tick less than the worst-case
+ *       execution time given to the scheduler, the default of
+ *       schedSimulator -t, with which no job overruns.
+ *   -S  Server period and budget in ticks. Without it, the server gets a
+ *       budget of one tick in a period longer than any run, so that it
+ *       neither takes nor reserves processor time.
+ *   -d  Simulated ticks per set, 60000 by default.
+ *   -s  Seed, 1 by default. The same seed gives the same sets.
+ *   -j  Number of sets simulated in parallel.
+ *   -p  Path of schedSimulator, ./schedSimulator by default.
+ *   -b  Baseline, a previous output of schedBenchmark with the same options.
+ *   -r  Tolerated increase of the overhead over the baseline in percent, 100
+ *       by default. Applies to the median over the utilizations.
+ *
+ * Options after -- are passed to schedSimulator, for example the aperiodic
+ * arrivals with -a and -e. Utilizations are split over the tasks with
+ * UUniFast. schedSimulator must be built with schedUSE_OVERLOAD_POLICIES and
+ * schedUSE_OVERHEAD_STATS, and with schedUSE_ADMISSION_CONTROL for the
+ * admitted column to mean anything.
+ *
+ * Columns: utilization, sets, fraction of sets admitted, fraction of sets
+ * admitted without a deadline miss in the run, deadline misses per job of
+ * the admitted sets, mean of the mean and of the 99th percentile aperiodic
+ * response time of the sets that served aperiodic jobs, and the median of
+ * the mean and the maximum of the maximum execution time of the tick hook,
+ * the scheduler task and the priority ranking of the admitted sets, in host
+ * nanoseconds.
+ *
+ * Everything but the overhead is simulated in virtual time, and only
+ * changes with the scheduler. The baseline check fails on any decrease of
+ * the schedulable fraction, any increase of the miss rate or the aperiodic
+ * response times, and on a median over the utilizations of the mean
+ * overhead of a part above the tolerance. Fails as well if -n asks for more
+ * tasks than schedSimulator -L prints. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/* Tolerance of the comparison of simulated results with the baseline. */
+#define benchEPSILON 1e-9
+
+/* Run of the server when -S is not given, in ticks. */
+#define benchIDLE_SERVER_PERIOD 1000000000UL
+
+typedef struct benchSetResult
+{
+  bool xValid;
+  bool xAdmitted;
+  unsigned long ulJobs;
+  unsigned long ulMissed;
+  unsigned long ulServed;
+  double dResponseMean;
+  double dResponseP99;
+  double pdOverheadMean[ 3 ];
+  double pdOverheadMax[ 3 ];
+} BenchSetResult_t;
+
+/* One output line. */
+typedef struct benchLevel
+{
+  double dUtilization;
+  unsigned long ulSets;
+  double dAdmitted;
+  double dSchedulable;
+  double dMissRate;
+  double dResponseMean;
+  double dResponseP99;
+  double pdOverheadMean[ 3 ];
+  double pdOverheadMax[ 3 ];
+} BenchLevel_t;
+
+static const char *const pcOverheadNames[ 3 ] = { "tick_hook", "scheduler_task", "priorities" };
+
+static double dFrom = 0.5, dTo = 0.95, dStep = 0.05;
+static unsigned long ulSetsPerLevel = 20;
+static unsigned long ulMinTasks = 2, ulMaxTasks = 6;
+static unsigned long ulMinPeriod = 10, ulMaxPeriod = 1000;
+static double dExecFraction = 1.0;
+static unsigned long ulServerPeriod = 0, ulServerBudget = 0;
+static unsigned long ulDuration = 60000;
+static unsigned long ulSeed = 1;
+static unsigned long ulJobs = 1;
+static const char *pcSimulator = "./schedSimulator";
+static const char *pcBaseline = NULL;
+static double dTolerance = 100.0;
+static std::string xSimulatorOptions;
+
+static void prvUsage( void )
+{
+  fprintf( stderr, "usage: schedBenchmark [-u from:to:step] [-m sets] [-n min:max] [-T min:max] [-c fraction]\n"
+                   "                      [-S period:budget] [-d ticks] [-s seed] [-j jobs] [-p simulator]\n"
+                   "                      [-b baseline] [-r percent] [-- simulator options]\n" );
+  exit( 1 );
+}
+
+static bool prvParseRange( const char *pcArg, unsigned long *pulMin, unsigned long *pulMax )
+{
+  char *pcEnd;
+
+  *pulMin = strtoul( pcArg, &pcEnd, 10 );
+  if( ':' != *pcEnd )
+  {
+    return false;
+  }
+  *pulMax = strtoul( pcEnd + 1, &pcEnd, 10 );
+  return '\0' == *pcEnd && 0 != *pulMin && *pulMin <= *pulMax;
+}
+
+/* Splits dUtilization over uxTasks tasks, uniformly over all splits. */
+static std::vector< double > prvUUniFast( std::mt19937_64 *pxRandom, size_t uxTasks, double dUtilization )
+{
+  std::uniform_real_distribution< double > xUniform( 0.0, 1.0 );
+  std::vector< double > xUtilizations;
+  double dSum = dUtilization;
+
+  for( size_t uxTask = 1; uxTask < uxTasks; uxTask++ )
+  {
+    double dNext = dSum * pow( xUniform( *pxRandom ), 1.0 / ( double ) ( uxTasks - uxTask ) );
+    xUtilizations.push_back( dSum - dNext );
+    dSum = dNext;
+  }
+  xUtilizations.push_back( dSum );
+  return xUtilizations;
+}
+
+/* Returns the schedSimulator command line of one random set. */
+static std::string prvGenerateSet( double dUtilization, unsigned long ulLevel, unsigned long ulSet )
+{
+  std::seed_seq xSeed = { ( uint32_t ) ulSeed, ( uint32_t ) ulLevel, ( uint32_t ) ulSet };
+  std::mt19937_64 xRandom( xSeed );
+  std::uniform_int_distribution< unsigned long > xTaskCount( ulMinTasks, ulMaxTasks );
+  std::uniform_real_distribution< double > xLogPeriod( log( ( double ) ulMinPeriod ), log( ( double ) ulMaxPeriod + 1.0 ) );
+  std::string xCommand = pcSimulator;
+  char pcArg[ 128 ];
+
+  if( 0 != ulServerPeriod )
+  {
+    dUtilization -= ( double ) ulServerBudget / ( double ) ulServerPeriod;
+  }
+
+  for( double dTaskUtilization : prvUUniFast( &xRandom, xTaskCount( xRandom ), dUtilization ) )
+  {
+    unsigned long ulPeriod = std::min( ulMaxPeriod, ( unsigned long ) exp( xLogPeriod( xRandom ) ) );
+    unsigned long ulExecTime = std::max( 2UL, ( unsigned long ) ( dTaskUtilization * ( double ) ulPeriod + 0.5 ) );
+
+    snprintf( pcArg, sizeof( pcArg ), " -t %lu,%lu,%lu", ulPeriod, ulExecTime, ulPeriod );
+    xCommand += pcArg;
+    if( dExecFraction < 1.0 )
+    {
+      snprintf( pcArg, sizeof( pcArg ), ",u:%g:%lu", std::max( 1.0, dExecFraction * ( double ) ( ulExecTime - 1 ) ), ulExecTime - 1 );
+      xCommand += pcArg;
+    }
+  }
+
+  snprintf( pcArg, sizeof( pcArg ), " -P %lu -B %lu -d %lu -s %lu",
+            ( 0 != ulServerPeriod ) ? ulServerPeriod : benchIDLE_SERVER_PERIOD, ( 0 != ulServerPeriod ) ? ulServerBudget : 1UL,
+            ulDuration, ulSeed * 1000003UL + ulLevel * 1009UL + ulSet );
+  xCommand += pcArg;
+  xCommand += xSimulatorOptions;
+  return xCommand;
+}
+
+/* Returns the largest number of periodic tasks that the simulator runs. */
+static unsigned long prvSimulatorTaskLimit( void )
+{
+  std::string xCommand = std::string( pcSimulator ) + " -L";
+  FILE *pxOutput = popen( xCommand.c_str(), "r" );
+  unsigned long ulLimit = 0;
+
+  if( NULL == pxOutput )
+  {
+    perror( "popen" );
+    exit( 1 );
+  }
+  if( 1 != fscanf( pxOutput, "%lu", &ulLimit ) )
+  {
+    ulLimit = 0;
+  }
+  pclose( pxOutput );
+  return ulLimit;
+}
+
+static std::vector< std::string > prvSplit( const std::string &xLine )
+{
+  std::vector< std::string > xFields;
+  size_t uxStart = 0, uxComma;
+
+  while( std::string::npos != ( uxComma = xLine.find( ',', uxStart ) ) )
+  {
+    xFields.push_back( xLine.substr( uxStart, uxComma - uxStart ) );
+    uxStart = uxComma + 1;
+  }
+  xFields.push_back( xLine.substr( uxStart ) );
+  return xFields;
+}
+
+static bool prvEndsWith( const std::string &xName, const char *pcSuffix )
+{
+  size_t uxLength = strlen( pcSuffix );
+  return xName.size() >= uxLength && 0 == xName.compare( xName.size() - uxLength, uxLength, pcSuffix );
+}
+
+static bool prvReadLine( FILE *pxFile, std::string *pxLine )
+{
+  char pcBuffer[ 512 ];
+
+  pxLine->clear();
+  while( NULL != fgets( pcBuffer, sizeof( pcBuffer ), pxFile ) )
+  {
+    *pxLine += pcBuffer;
+    if( '\n' == pxLine->back() )
+    {
+      pxLine->pop_back();
+      return true;
+    }
+  }
+  return !pxLine->empty();
+}
+
+/* Reads the header and the result line of one schedSimulator run. */
+static BenchSetResult_t prvReadSetResult( FILE *pxOutput )
+{
+  BenchSetResult_t xResult;
+  std::string xHeader, xLine;
+  std::vector< std::string > xNames, xValues;
+  bool pxOverheadSeen[ 3 ] = { false, false, false };
+  bool xMissesSeen = false;
+
+  memset( &xResult, 0, sizeof( xResult ) );
+  if( !prvReadLine( pxOutput, &xHeader ) || !prvReadLine( pxOutput, &xLine ) )
+  {
+    return xResult;
+  }
+  xNames = prvSplit( xHeader );
+  xValues = prvSplit( xLine );
+  if( xNames.size() != xValues.size() )
+  {
+    return xResult;
+  }
+
+  for( size_t uxColumn = 0; uxColumn < xNames.size(); uxColumn++ )
+  {
+    const std::string &xName = xNames[ uxColumn ];
+    const char *pcValue = xValues[ uxColumn ].c_str();
+
+    if( "status" == xName )
+    {
+      xResult.xAdmitted = ( 0 == strcmp( pcValue, "ok" ) );
+    }
+    else if( "aperiodic_served" == xName )
+    {
+      xResult.ulServed = strtoul( pcValue, NULL, 10 );
+    }
+    else if( "response_mean" == xName )
+    {
+      xResult.dResponseMean = strtod( pcValue, NULL );
+    }
+    else if( "response_p99" == xName )
+    {
+      xResult.dResponseP99 = strtod( pcValue, NULL );
+    }
+    else if( prvEndsWith( xName, "_completed" ) || prvEndsWith( xName, "_aborted" ) )
+    {
+      xResult.ulJobs += strtoul( pcValue, NULL, 10 );
+    }
+    else if( prvEndsWith( xName, "_missed" ) )
+    {
+      xResult.ulMissed += strtoul( pcValue, NULL, 10 );
+      xMissesSeen = true;
+    }
+    else
+    {
+      for( int iPart = 0; iPart < 3; iPart++ )
+      {
+        std::string xPart = pcOverheadNames[ iPart ];
+        if( xPart + "_mean" == xName )
+        {
+          xResult.pdOverheadMean[ iPart ] = strtod( pcValue, NULL );
+          pxOverheadSeen[ iPart ] = true;
+        }
+        else if( xPart + "_max" == xName )
+        {
+          xResult.pdOverheadMax[ iPart ] = strtod( pcValue, NULL );
+        }
+      }
+    }
+  }
+
+  if( !xMissesSeen || !pxOverheadSeen[ 0 ] || !pxOverheadSeen[ 1 ] || !pxOverheadSeen[ 2 ] )
+  {
+    fprintf( stderr, "schedSimulator must be built with schedUSE_OVERLOAD_POLICIES and schedUSE_OVERHEAD_STATS\n" );
+    exit( 1 );
+  }
+  xResult.xValid = true;
+  return xResult;
+}
+
+/* Median of pxValues, the upper one of an even count. */
+static double prvMedian( std::vector< double > pxValues )
+{
+  std::vector< double >::iterator xMedian = pxValues.begin() + pxValues.size() / 2;
+
+  std::nth_element( pxValues.begin(), xMedian, pxValues.end() );
+  return *xMedian;
+}
+
+static BenchLevel_t prvRunLevel( double dUtilization, unsigned long ulLevel )
+{
+  BenchLevel_t xLevel;
+  std::vector< BenchSetResult_t > xResults;
+  std::vector< double > pxOverheadMeans[ 3 ];
+  unsigned long ulAdmitted = 0, ulSchedulable = 0, ulJobCount = 0, ulMissed = 0, ulAperiodicSets = 0;
+
+  memset( &xLevel, 0, sizeof( xLevel ) );
+  xLevel.dUtilization = dUtilization;
+
+  /* Sets are started ulJobs at a time. */
+  for( unsigned long ulFirst = 0; ulFirst < ulSetsPerLevel; ulFirst += ulJobs )
+  {
+    unsigned long ulEnd = std::min( ulSetsPerLevel, ulFirst + ulJobs );
+    std::vector< FILE * > xOutputs;
+
+    for( unsigned long ulSet = ulFirst; ulSet < ulEnd; ulSet++ )
+    {
+      std::string xCommand = prvGenerateSet( dUtilization, ulLevel, ulSet );
+      FILE *pxOutput = popen( xCommand.c_str(), "r" );
+
+      if( NULL == pxOutput )
+      {
+        perror( "popen" );
+        exit( 1 );
+      }
+      xOutputs.push_back( pxOutput );
+    }
+    for( FILE *pxOutput : xOutputs )
+    {
+      xResults.push_back( prvReadSetResult( pxOutput ) );
+      pclose( pxOutput );
+      if( !xResults.back().xValid )
+      {
+        fprintf( stderr, "a set at utilization %.3f failed, see %s\n", dUtilization, pcSimulator );
+        exit( 1 );
+      }
+    }
+  }
+
+  for( const BenchSetResult_t &xResult : xResults )
+  {
+    xLevel.ulSets++;
+    if( !xResult.xAdmitted )
+    {
+      continue;
+    }
+    ulAdmitted++;
+    ulSchedulable += ( 0 == xResult.ulMissed ) ? 1 : 0;
+    ulJobCount += xResult.ulJobs;
+    ulMissed += xResult.ulMissed;
+    if( 0 != xResult.ulServed )
+    {
+      ulAperiodicSets++;
+      xLevel.dResponseMean += xResult.dResponseMean;
+      xLevel.dResponseP99 += xResult.dResponseP99;
+    }
+    for( int iPart = 0; iPart < 3; iPart++ )
+    {
+      pxOverheadMeans[ iPart ].push_back( xResult.pdOverheadMean[ iPart ] );
+      xLevel.pdOverheadMax[ iPart ] = std::max( xLevel.pdOverheadMax[ iPart ], xResult.pdOverheadMax[ iPart ] );
+    }
+  }
+
+  xLevel.dAdmitted = ( double ) ulAdmitted / ( double ) xLevel.ulSets;
+  xLevel.dSchedulable = ( double ) ulSchedulable / ( double ) xLevel.ulSets;
+  xLevel.dMissRate = ( 0 == ulJobCount ) ? 0.0 : ( double ) ulMissed / ( double ) ulJobCount;
+  if( 0 != ulAperiodicSets )
+  {
+    xLevel.dResponseMean /= ( double ) ulAperiodicSets;
+    xLevel.dResponseP99 /= ( double ) ulAperiodicSets;
+  }
+  /* The median of the sets, as a run that the host preempts in the middle
+   * of a measurement has an outlier in its mean. */
+  for( int iPart = 0; iPart < 3 && 0 != ulAdmitted; iPart++ )
+  {
+    xLevel.pdOverheadMean[ iPart ] = prvMedian( pxOverheadMeans[ iPart ] );
+  }
+  return xLevel;
+}
+
+/* Formats one output line, without the newline. */
+static std::string prvFormatLevel( const BenchLevel_t *pxLevel )
+{
+  char pcLine[ 256 ];
+  int iLength;
+
+  iLength = snprintf( pcLine, sizeof( pcLine ), "%.3f,%lu,%.4f,%.4f,%.6f,%.2f,%.2f", pxLevel->dUtilization, pxLevel->ulSets,
+                      pxLevel->dAdmitted, pxLevel->dSchedulable, pxLevel->dMissRate, pxLevel->dResponseMean, pxLevel->dResponseP99 );
+  for( int iPart = 0; iPart < 3; iPart++ )
+  {
+    iLength += snprintf( pcLine + iLength, sizeof( pcLine ) - ( size_t ) iLength, ",%.1f,%.0f",
+                         pxLevel->pdOverheadMean[ iPart ], pxLevel->pdOverheadMax[ iPart ] );
+  }
+  return pcLine;
+}
+
+/* Parses an output line. Results are compared as they are printed, so that
+ * a baseline matches the run it was written by exactly. */
+static bool prvParseLevel( const std::string &xLine, BenchLevel_t *pxLevel )
+{
+  std::vector< std::string > xFields = prvSplit( xLine );
+
+  if( 13 != xFields.size() )
+  {
+    return false;
+  }
+  pxLevel->dUtilization = strtod( xFields[ 0 ].c_str(), NULL );
+  pxLevel->ulSets = strtoul( xFields[ 1 ].c_str(), NULL, 10 );
+  pxLevel->dAdmitted = strtod( xFields[ 2 ].c_str(), NULL );
+  pxLevel->dSchedulable = strtod( xFields[ 3 ].c_str(), NULL );
+  pxLevel->dMissRate = strtod( xFields[ 4 ].c_str(), NULL );
+  pxLevel->dResponseMean = strtod( xFields[ 5 ].c_str(), NULL );
+  pxLevel->dResponseP99 = strtod( xFields[ 6 ].c_str(), NULL );
+  for( int iPart = 0; iPart < 3; iPart++ )
+  {
+    pxLevel->pdOverheadMean[ iPart ] = strtod( xFields[ 7 + 2 * iPart ].c_str(), NULL );
+    pxLevel->pdOverheadMax[ iPart ] = strtod( xFields[ 8 + 2 * iPart ].c_str(), NULL );
+  }
+  return true;
+}
+
+/* Reads a previous output, indexed by the utilization column. */
+static std::map< std::string, BenchLevel_t > prvReadBaseline( const char *pcPath )
+{
+  std::map< std::string, BenchLevel_t > xBaseline;
+  FILE *pxFile = fopen( pcPath, "r" );
+  std::string xLine;
+
+  if( NULL == pxFile )
+  {
+    perror( pcPath );
+    exit( 1 );
+  }
+  /* The first line is the header. */
+  prvReadLine( pxFile, &xLine );
+  while( prvReadLine( pxFile, &xLine ) )
+  {
+    BenchLevel_t xLevel;
+
+    if( prvParseLevel( xLine, &xLevel ) )
+    {
+      xBaseline[ xLine.substr( 0, xLine.find( ',' ) ) ] = xLevel;
+    }
+  }
+  fclose( pxFile );
+  return xBaseline;
+}
+
+static bool prvCheckWorse( const char *pcUtilization, const char *pcName, double dValue, double dLimit, double dBaseline )
+{
+  if( dValue > dLimit )
+  {
+    fprintf( stderr, "regression at utilization %s: %s %.6g, baseline %.6g\n", pcUtilization, pcName, dValue, dBaseline );
+    return true;
+  }
+  return false;
+}
+
+/* Returns true if the simulated results of pxLevel are worse than its
+ * baseline line. */
+static bool prvCompareLevel( const BenchLevel_t *pxLevel, const BenchLevel_t *pxBase, const char *pcUtilization )
+{
+  bool xWorse = false;
+
+  /* The schedulable fraction must not decrease, the others must not grow. */
+  xWorse |= prvCheckWorse( pcUtilization, "unschedulable", 1.0 - pxLevel->dSchedulable, 1.0 - pxBase->dSchedulable + benchEPSILON, 1.0 - pxBase->dSchedulable );
+  xWorse |= prvCheckWorse( pcUtilization, "miss_rate", pxLevel->dMissRate, pxBase->dMissRate + benchEPSILON, pxBase->dMissRate );
+  xWorse |= prvCheckWorse( pcUtilization, "aperiodic_mean", pxLevel->dResponseMean, pxBase->dResponseMean + benchEPSILON, pxBase->dResponseMean );
+  xWorse |= prvCheckWorse( pcUtilization, "aperiodic_p99", pxLevel->dResponseP99, pxBase->dResponseP99 + benchEPSILON, pxBase->dResponseP99 );
+  return xWorse;
+}
+
+/* Returns true if the median over the utilizations of the mean overhead of
+ * a part is above that of the baseline by more than the tolerance. The load
+ * of the host shifts all the utilizations of a run together, by more than
+ * the tolerance at some of them, and the median evens that out. Levels where
+ * the run or the baseline admitted no set have no overhead and are left out. */
+static bool prvCompareOverhead( const std::vector< BenchLevel_t > &pxLevels, const std::vector< BenchLevel_t > &pxBases )
+{
+  bool xWorse = false;
+  double dFactor = 1.0 + dTolerance / 100.0;
+
+  for( int iPart = 0; iPart < 3; iPart++ )
+  {
+    std::vector< double > pxMeans, pxBaseMeans;
+
+    for( size_t x = 0; x < pxLevels.size(); x++ )
+    {
+      if( 0.0 != pxLevels[ x ].dAdmitted && 0.0 != pxBases[ x ].dAdmitted )
+      {
+        pxMeans.push_back( pxLevels[ x ].pdOverheadMean[ iPart ] );
+        pxBaseMeans.push_back( pxBases[ x ].pdOverheadMean[ iPart ] );
+      }
+    }
+    if( !pxMeans.empty() && prvMedian( pxMeans ) > prvMedian( pxBaseMeans ) * dFactor )
+    {
+      fprintf( stderr, "regression over all utilizations: %s_mean median %.6g, baseline %.6g\n",
+               pcOverheadNames[ iPart ], prvMedian( pxMeans ), prvMedian( pxBaseMeans ) );
+      xWorse = true;
+    }
+  }
+  return xWorse;
+}
+
+int main( int argc, char **argv )
+{
+  std::map< std::string, BenchLevel_t > xBaseline;
+  std::vector< BenchLevel_t > pxCompared, pxComparedBases;
+  bool xWorse = false;
+  unsigned long ulLevels, ulTaskLimit;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    const char *pcArg = ( i + 1 < argc ) ? argv[ i + 1 ] : NULL;
+    bool xValid = ( NULL != pcArg );
+
+    if( 0 == strcmp( argv[ i ], "--" ) )
+    {
+      /* The simulator options are simple words, quoted for the shell. */
+      for( i++; i < argc; i++ )
+      {
+        if( NULL != strchr( argv[ i ], '\'' ) )
+        {
+          prvUsage();
+        }
+        xSimulatorOptions += " '";
+        xSimulatorOptions += argv[ i ];
+        xSimulatorOptions += "'";
+      }
+      break;
+    }
+    if( 0 == strcmp( argv[ i ], "-u" ) && xValid )
+    {
+      xValid = ( 3 == sscanf( pcArg, "%lf:%lf:%lf", &dFrom, &dTo, &dStep ) && dFrom > 0.0 && dFrom <= dTo && dStep > 0.0 );
+    }
+    else if( 0 == strcmp( argv[ i ], "-m" ) && xValid )
+    {
+      ulSetsPerLevel = strtoul( pcArg, NULL, 10 );
+      xValid = ( 0 != ulSetsPerLevel );
+    }
+    else if( 0 == strcmp( argv[ i ], "-n" ) && xValid )
+    {
+      xValid = prvParseRange( pcArg, &ulMinTasks, &ulMaxTasks );
+    }
+    else if( 0 == strcmp( argv[ i ], "-T" ) && xValid )
+    {
+      xValid = prvParseRange( pcArg, &ulMinPeriod, &ulMaxPeriod );
+    }
+    else if( 0 == strcmp( argv[ i ], "-c" ) && xValid )
+    {
+      dExecFraction = strtod( pcArg, NULL );
+      xValid = ( dExecFraction > 0.0 && dExecFraction <= 1.0 );
+    }
+    else if( 0 == strcmp( argv[ i ], "-S" ) && xValid )
+    {
+      xValid = ( 2 == sscanf( pcArg, "%lu:%lu", &ulServerPeriod, &ulServerBudget ) && 0 != ulServerBudget && ulServerBudget <= ulServerPeriod );
+    }
+    else if( 0 == strcmp( argv[ i ], "-d" ) && xValid )
+    {
+      ulDuration = strtoul( pcArg, NULL, 10 );
+      xValid = ( 0 != ulDuration );
+    }
+    else if( 0 == strcmp( argv[ i ], "-s" ) && xValid )
+    {
+      ulSeed = strtoul( pcArg, NULL, 10 );
+    }
+    else if( 0 == strcmp( argv[ i ], "-j" ) && xValid )
+    {
+      ulJobs = strtoul( pcArg, NULL, 10 );
+      xValid = ( 0 != ulJobs );
+    }
+    else if( 0 == strcmp( argv[ i ], "-p" ) && xValid )
+    {
+      pcSimulator = pcArg;
+    }
+    else if( 0 == strcmp( argv[ i ], "-b" ) && xValid )
+    {
+      pcBaseline = pcArg;
+    }
+    else if( 0 == strcmp( argv[ i ], "-r" ) && xValid )
+    {
+      dTolerance = strtod( pcArg, NULL );
+      xValid = ( dTolerance >= 0.0 );
+    }
+    else
+    {
+      xValid = false;
+    }
+
+    if( !xValid )
+    {
+      prvUsage();
+    }
+    i++;
+  }
+
+  ulTaskLimit = prvSimulatorTaskLimit();
+  if( 0 == ulTaskLimit )
+  {
+    fprintf( stderr, "%s -L failed, see -p\n", pcSimulator );
+    return 1;
+  }
+  if( ulMaxTasks > ulTaskLimit )
+  {
+    fprintf( stderr, "%s runs at most %lu periodic tasks, -n asks for %lu\n", pcSimulator, ulTaskLimit, ulMaxTasks );
+    return 1;
+  }
+
+  if( NULL != pcBaseline )
+  {
+    xBaseline = prvReadBaseline( pcBaseline );
+  }
+
+  printf( "utilization,sets,admitted,schedulable,miss_rate,aperiodic_mean,aperiodic_p99" );
+  for( int iPart = 0; iPart < 3; iPart++ )
+  {
+    printf( ",%s_mean,%s_max", pcOverheadNames[ iPart ], pcOverheadNames[ iPart ] );
+  }
+  printf( "\n" );
+  fflush( stdout );
+
+  ulLevels = ( unsigned long ) ( ( dTo - dFrom ) / dStep + benchEPSILON ) + 1;
+  for( unsigned long ulLevel = 0; ulLevel < ulLevels; ulLevel++ )
+  {
+    BenchLevel_t xLevel = prvRunLevel( dFrom + ( double ) ulLevel * dStep, ulLevel );
+    std::string xLine = prvFormatLevel( &xLevel );
+    std::string xUtilization = xLine.substr( 0, xLine.find( ',' ) );
+
+    printf( "%s\n", xLine.c_str() );
+    fflush( stdout );
+
+    if( NULL != pcBaseline )
+    {
+      std::map< std::string, BenchLevel_t >::const_iterator xBase = xBaseline.find( xUtilization );
+      if( xBaseline.end() == xBase )
+      {
+        fprintf( stderr, "utilization %s is not in the baseline\n", xUtilization.c_str() );
+        xWorse = true;
+      }
+      else
+      {
+        prvParseLevel( xLine, &xLevel );
+        xWorse |= prvCompareLevel( &xLevel, &xBase->second, xUtilization.c_str() );
+        pxCompared.push_back( xLevel );
+        pxComparedBases.push_back( xBase->second );
+      }
+    }
+  }
+  xWorse |= prvCompareOverhead( pxCompared, pxComparedBases );
+
+  return xWorse ? 2 : 0;
+}
@@ -0,0 +1,86 @@
+#!/bin/sh
+# Scenario tests of the scheduler in the simulator of tools/schedSimulator.cpp.
+# Each scenario builds the simulator with the scheduler options it needs, runs
+# a short task set and checks columns of the CSV output. Prints one line per
+# check, and exits with status 1 if one of them fails.
+#
+# Usage: tools/schedScenarios.sh <path to FreeRTOS-Kernel or src/sim/kernel>
+
+K=$(cd "${1:?usage: $0 <path to FreeRTOS-Kernel>}" && pwd) || exit 1
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+FAILED=0
+
+# build <name> <compiler options>...
+# Builds the simulator as $WORK/<name>. The kernel is compiled as C.
+build()
+{
+  NAME=$1
+  shift
+  mkdir -p "$WORK/$NAME.o"
+  I="-I$ROOT/src/sim -I$ROOT/src/host -I$ROOT/src -I$K/include"
+  if ! ( cd "$WORK/$NAME.o" && gcc -O2 -c $I "$@" $K/tasks.c $K/list.c $K/queue.c $K/timers.c $K/event_groups.c \
+           $K/stream_buffer.c $K/portable/MemMang/heap_3.c "$ROOT/src/sim/port.c" ) ||
+     ! g++ -O2 $I "$@" "$ROOT/tools/schedSimulator.cpp" "$ROOT/src/scheduler.cpp" "$ROOT/src/host/Arduino.cpp" \
+           "$WORK/$NAME.o"/*.o -o "$WORK/$NAME"
+  then
+    echo "FAIL $NAME: does not build"
+    FAILED=1
+  fi
+}
+
+# expect <name> <column> <value> <simulator options>...
+# Runs the simulator <name> and compares <column> of the first result line.
+expect()
+{
+  NAME=$1
+  COLUMN=$2
+  VALUE=$3
+  shift 3
+  [ -x "$WORK/$NAME" ] || return
+  GOT=$("$WORK/$NAME" "$@" | awk -F, -v c="$COLUMN" 'NR == 1 { for( i = 1; i <= NF; i++ ) if( $i == c ) n = i } NR == 2 && n { print $n }')
+  if [ "$GOT" = "$VALUE" ]
+  then
+    echo "ok   $NAME: $COLUMN is $VALUE"
+  else
+    echo "FAIL $NAME: $COLUMN is '$GOT', expected $VALUE"
+    FAILED=1
+  fi
+}
+
+# A sporadic server defers a job that does not fit the budget it has left.
+# The replenishment has to start the job, no other job arrives to wake the
+# server.
+build sporadic -DPOLLING_SERVER_MODE=POLLING_SERVER_MODE_SPORADIC
+expect sporadic aperiodic_served 2 -t 1000,100,1000,c:50 -A 10:15:100 -A 12:15:200 -P 100 -B 20 -d 1000
+
+# The same with every option that adds a field to SchedTCB_t. This is the
+# largest extended TCB, which only builds while it fits schedTCB_MAX_SIZE.
+build full -DPOLLING_SERVER_MODE=POLLING_SERVER_MODE_SPORADIC -DschedUSE_SUBTICK_ACCOUNTING=1 -DschedUSE_MODE_CHANGE=1 \
+           -DschedUSE_ADMISSION_CONTROL=1
+expect full aperiodic_served 2 -t 1000,100,1000,c:50 -A 10:15:100 -A 12:15:200 -P 100 -B 20 -d 1000
+
+# Audsley's assignment with more tasks than priority levels. The lowest
+# level is shared, and the admission control checks it.
+build opa -DschedSCHEDULING_POLICY=schedSCHEDULING_POLICY_OPA -DschedUSE_ADMISSION_CONTROL=1 -DconfigMAX_PRIORITIES=4
+expect opa t4_completed 10 -t 100,10,100,c:8 -t 150,10,150,c:8 -t 200,10,200,c:8 -t 300,10,300,c:8 -P 400 -B 20 -d 3000
+expect opa status rejected -t 100,40,100 -t 150,40,150 -t 200,30,200 -t 300,10,300 -P 400 -B 20 -d 3000
+
+# A job that misses its deadline is aborted, and its task is recreated in
+# the static buffers of its TCB slot. The task goes on with its next job.
+build static
+expect static t2_aborted 50 -t 100,20,100,c:15 -t 200,80,120,u:40:120 -d 20000
+expect static t2_completed 50 -t 100,20,100,c:15 -t 200,80,120,u:40:120 -d 20000
+
+# The overload policies, on a task that overruns half of its jobs. Each is
+# checked on the counter that it changes.
+O="-t 100,20,100,c:15 -t 200,80,120,u:40:120 -d 20000"
+expect static t2_aborted 0 $O -o continue
+expect static t2_late 35 $O -o continue
+expect static t2_skipped 30 $O -o skip
+expect static t2_completed 71 $O -o skip
+expect static t2_firm_violations 25 $O -o firm:2:3
+expect static t2_missed 0 $O -o abort
+
+exit $FAILED
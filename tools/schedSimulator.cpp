@@ -0,0 +1,738 @@
+/* Discrete-event simulator for the scheduler. The unmodified
+ * src/scheduler.cpp runs on the FreeRTOS kernel with the virtual-time port
+ * of src/sim, where a tick only passes when a task says it executes. Runs
+ * with the same seed and options give the same output, see README.md for a
+ * measured run time.
+ *
+ * Usage: schedSimulator -t T,C,D[,exec] [-o policy] [-t ...] [-a arrivals]
+ *                       [-e exec] [-A tick:exec:deadline ...] [-P periods]
+ *                       [-B budgets] [-d ticks] [-s seed] [-j jobs] [-v]
+ *        schedSimulator -L
+ *
+ *   -t  Periodic task with period T, worst-case execution time C and relative
+ *       deadline D in ticks. exec is the distribution of the execution time
+ *       of its jobs, C - 1 by default, at least 1. The scheduler charges a
+ *       tick to the task that runs when it occurs, and stops a job that is
+ *       charged C, so C - 1 is the longest execution that never overruns,
+ *       whatever the phase of the job to the tick. With C of 1, every job
+ *       overruns.
+ *   -o  Overload policy of the task given before it: recreate, continue,
+ *       skip, firm:M:K or abort, see the schedOVERLOAD_ defines. recreate
+ *       by default. Needs schedUSE_OVERLOAD_POLICIES.
+ *   -a  Aperiodic arrivals, poisson:GAP with a mean of GAP ticks between
+ *       jobs, or burst:GAP:SIZE for bursts of SIZE jobs with a mean of GAP
+ *       ticks between bursts.
+ *   -e  Execution time distribution of the aperiodic jobs, c:1 by default.
+ *   -A  One aperiodic job that arrives at the given tick, with the given
+ *       execution time and relative deadline in ticks. Its execution time is
+ *       declared, so the server only starts it when it fits the remaining
+ *       budget. Can be repeated, and combined with -a.
+ *   -P, -B  Comma separated server periods and budgets in ticks. Every
+ *       combination is simulated, 200 and 100 by default.
+ *   -d  Simulated ticks per run, a day by default.
+ *   -s  Seed of the random numbers, 1 by default.
+ *   -j  Number of runs simulated in parallel.
+ *   -v  Keep the scheduler log of the runs on stdout.
+ *   -L  Print the largest number of periodic tasks of a run and exit. The
+ *       server takes one task slot, and under RMS and DMS one level between
+ *       the idle task and the scheduler task, which every task needs too.
+ *
+ * Execution time distributions are c:N for a constant, u:A:B for uniform
+ * in [A,B] and e:MEAN for exponential, in ticks and at least 1.
+ *
+ * Prints one CSV line per combination: server period and budget, whether
+ * the admission control accepted the set, aperiodic jobs arrived, served
+ * and dropped because the queue was full, mean, median, 95th and 99th
+ * percentile and maximum response time of the served jobs, with
+ * schedUSE_OVERLOAD_POLICIES the completed jobs, deadline misses, overruns,
+ * aborted jobs, late completions, skipped releases and (m,k)-firm
+ * violations of every periodic task, and with schedUSE_OVERHEAD_STATS
+ * the mean and maximum execution time in host nanoseconds and the number of
+ * runs of the tick hook, the scheduler task and the priority ranking. The time the scheduler
+ * itself takes is measured, but not simulated. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "scheduler.h"
+
+/* A day at the tick rate of src/sim. */
+#define simDEFAULT_TICKS ( 24ULL * 60ULL * 60ULL * configTICK_RATE_HZ )
+
+/* Execution time distributions. */
+#define simDIST_CONSTANT 0
+#define simDIST_UNIFORM 1
+#define simDIST_EXPONENTIAL 2
+
+typedef struct simDistribution
+{
+  int iKind;
+  double dA;    /* Constant, lower bound or mean. */
+  double dB;    /* Upper bound of the uniform distribution. */
+} SimDistribution_t;
+
+typedef struct simTask
+{
+  TickType_t xPeriod;
+  TickType_t xMaxExecTime;
+  TickType_t xDeadline;
+  SimDistribution_t xExecTime;
+  UBaseType_t uxPolicy;     /* Overload policy, and its (m,k) constraint. */
+  UBaseType_t uxM;
+  UBaseType_t uxK;
+  TaskHandle_t xHandle;
+  char pcName[ configMAX_TASK_NAME_LEN ];
+} SimTask_t;
+
+/* Aperiodic arrival processes. */
+#define simARRIVALS_NONE 0
+#define simARRIVALS_POISSON 1
+#define simARRIVALS_BURST 2
+
+typedef struct simArrivals
+{
+  int iKind;
+  double dMeanGap;          /* Mean ticks between jobs or bursts. */
+  unsigned long ulBurstSize;
+} SimArrivals_t;
+
+/* An aperiodic job in the server queue. */
+typedef struct simJob
+{
+  uint64_t ullArrival;
+  TickType_t xExecTime;
+} SimJob_t;
+
+/* An aperiodic job given with -A. */
+typedef struct simExplicitJob
+{
+  uint64_t ullArrival;
+  TickType_t xExecTime;
+  TickType_t xDeadline;
+} SimExplicitJob_t;
+
+static std::vector< SimTask_t > xTasks;
+static SimArrivals_t xArrivals = { simARRIVALS_NONE, 0.0, 1 };
+static SimDistribution_t xAperiodicExecTime = { simDIST_CONSTANT, 1.0, 0.0 };
+static std::vector< SimExplicitJob_t > xExplicitJobs;
+static uint64_t ullDuration = simDEFAULT_TICKS;
+static unsigned long ulSeed = 1;
+static bool xVerbose = false;
+
+/* State of the run in a child process. */
+static std::mt19937_64 xRandom;
+static uint64_t ullTick = 0;
+static double dNextArrival = 0.0;
+static size_t uxNextExplicitJob = 0;
+static unsigned long ulArrived = 0;
+static unsigned long ulDropped = 0;
+static std::vector< uint32_t > xResponseTimes;
+static int iResultFd = -1;
+
+extern "C"
+{
+  unsigned long ulSimulatorServerPeriod = 200;
+  unsigned long ulSimulatorServerBudget = 100;
+}
+
+static void prvUsage( void )
+{
+  fprintf( stderr, "usage: schedSimulator -t T,C,D[,exec] [-o policy] [-t ...] [-a poisson:GAP|burst:GAP:SIZE]\n"
+                   "                      [-e exec] [-A tick:exec:deadline ...] [-P periods] [-B budgets]\n"
+                   "                      [-d ticks] [-s seed] [-j jobs] [-v]\n"
+                   "       schedSimulator -L\n"
+                   "exec: c:N | u:A:B | e:MEAN\n"
+                   "policy: recreate | continue | skip | firm:M:K | abort\n" );
+  exit( 1 );
+}
+
+/* Largest number of periodic tasks of a run, see -L. */
+static int prvMaxPeriodicTasks( void )
+{
+  int iMax = schedMAX_NUMBER_OF_PERIODIC_TASKS - 1;
+
+  #if( schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_RMS || schedSCHEDULING_POLICY == schedSCHEDULING_POLICY_DMS )
+    iMax = std::min( iMax, ( int ) schedSCHEDULER_PRIORITY - 2 );
+  #endif /* schedSCHEDULING_POLICY */
+  return iMax;
+}
+
+static bool prvParseDistribution( const char *pcArg, SimDistribution_t *pxDist )
+{
+  char *pcEnd;
+
+  pxDist->dB = 0.0;
+  if( 0 == strncmp( pcArg, "c:", 2 ) || 0 == strncmp( pcArg, "e:", 2 ) )
+  {
+    pxDist->iKind = ( 'c' == pcArg[ 0 ] ) ? simDIST_CONSTANT : simDIST_EXPONENTIAL;
+    pxDist->dA = strtod( pcArg + 2, &pcEnd );
+    return '\0' == *pcEnd && pxDist->dA > 0.0;
+  }
+  if( 0 == strncmp( pcArg, "u:", 2 ) )
+  {
+    pxDist->iKind = simDIST_UNIFORM;
+    pxDist->dA = strtod( pcArg + 2, &pcEnd );
+    if( ':' != *pcEnd )
+    {
+      return false;
+    }
+    pxDist->dB = strtod( pcEnd + 1, &pcEnd );
+    return '\0' == *pcEnd && pxDist->dA > 0.0 && pxDist->dB >= pxDist->dA;
+  }
+  return false;
+}
+
+static bool prvParseTask( const char *pcArg, SimTask_t *pxTask )
+{
+  char *pcEnd;
+
+  pxTask->xPeriod = ( TickType_t ) strtoul( pcArg, &pcEnd, 10 );
+  if( ',' != *pcEnd )
+  {
+    return false;
+  }
+  pxTask->xMaxExecTime = ( TickType_t ) strtoul( pcEnd + 1, &pcEnd, 10 );
+  if( ',' != *pcEnd )
+  {
+    return false;
+  }
+  pxTask->xDeadline = ( TickType_t ) strtoul( pcEnd + 1, &pcEnd, 10 );
+  if( 0 == pxTask->xPeriod || 0 == pxTask->xMaxExecTime || 0 == pxTask->xDeadline )
+  {
+    return false;
+  }
+
+  pxTask->xExecTime.iKind = simDIST_CONSTANT;
+  pxTask->xExecTime.dA = ( double ) ( std::max( pxTask->xMaxExecTime, ( TickType_t ) 2 ) - 1 );
+  pxTask->xExecTime.dB = 0.0;
+  if( ',' == *pcEnd )
+  {
+    return prvParseDistribution( pcEnd + 1, &pxTask->xExecTime );
+  }
+  return '\0' == *pcEnd;
+}
+
+#if( schedUSE_OVERLOAD_POLICIES == 1 )
+  static bool prvParsePolicy( const char *pcArg, SimTask_t *pxTask )
+  {
+    unsigned long ulM, ulK;
+    int iLength = 0;
+
+    pxTask->uxM = 1;
+    pxTask->uxK = 1;
+    if( 0 == strcmp( pcArg, "recreate" ) )
+    {
+      pxTask->uxPolicy = schedOVERLOAD_RECREATE;
+    }
+    else if( 0 == strcmp( pcArg, "continue" ) )
+    {
+      pxTask->uxPolicy = schedOVERLOAD_CONTINUE;
+    }
+    else if( 0 == strcmp( pcArg, "skip" ) )
+    {
+      pxTask->uxPolicy = schedOVERLOAD_SKIP_NEXT;
+    }
+    else if( 0 == strcmp( pcArg, "abort" ) )
+    {
+      pxTask->uxPolicy = schedOVERLOAD_ABORT_JOB;
+    }
+    else if( 2 == sscanf( pcArg, "firm:%lu:%lu%n", &ulM, &ulK, &iLength ) && '\0' == pcArg[ iLength ] &&
+             0 < ulM && ulM <= ulK && ulK <= schedOVERLOAD_FIRM_MAX_K )
+    {
+      pxTask->uxPolicy = schedOVERLOAD_FIRM;
+      pxTask->uxM = ( UBaseType_t ) ulM;
+      pxTask->uxK = ( UBaseType_t ) ulK;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+#endif /* schedUSE_OVERLOAD_POLICIES */
+
+static bool prvParseArrivals( const char *pcArg )
+{
+  char *pcEnd;
+
+  if( 0 == strncmp( pcArg, "poisson:", 8 ) )
+  {
+    xArrivals.iKind = simARRIVALS_POISSON;
+    xArrivals.dMeanGap = strtod( pcArg + 8, &pcEnd );
+    xArrivals.ulBurstSize = 1;
+    return '\0' == *pcEnd && xArrivals.dMeanGap > 0.0;
+  }
+  if( 0 == strncmp( pcArg, "burst:", 6 ) )
+  {
+    xArrivals.iKind = simARRIVALS_BURST;
+    xArrivals.dMeanGap = strtod( pcArg + 6, &pcEnd );
+    if( ':' != *pcEnd )
+    {
+      return false;
+    }
+    xArrivals.ulBurstSize = strtoul( pcEnd + 1, &pcEnd, 10 );
+    return '\0' == *pcEnd && xArrivals.dMeanGap > 0.0 && xArrivals.ulBurstSize > 0;
+  }
+  return false;
+}
+
+static bool prvParseExplicitJob( const char *pcArg, SimExplicitJob_t *pxJob )
+{
+  unsigned long long ullArrival;
+  unsigned long ulExecTime, ulDeadline;
+  int iLength = 0;
+
+  if( 3 != sscanf( pcArg, "%llu:%lu:%lu%n", &ullArrival, &ulExecTime, &ulDeadline, &iLength ) || '\0' != pcArg[ iLength ] ||
+      0 == ulExecTime || 0 == ulDeadline )
+  {
+    return false;
+  }
+  pxJob->ullArrival = ullArrival;
+  pxJob->xExecTime = ( TickType_t ) ulExecTime;
+  pxJob->xDeadline = ( TickType_t ) ulDeadline;
+  return true;
+}
+
+static bool prvParseList( const char *pcArg, std::vector< unsigned long > *pxList )
+{
+  char *pcEnd;
+
+  pxList->clear();
+  for( ;; )
+  {
+    unsigned long ulValue = strtoul( pcArg, &pcEnd, 10 );
+    if( pcEnd == pcArg || 0 == ulValue )
+    {
+      return false;
+    }
+    pxList->push_back( ulValue );
+    if( '\0' == *pcEnd )
+    {
+      return true;
+    }
+    if( ',' != *pcEnd )
+    {
+      return false;
+    }
+    pcArg = pcEnd + 1;
+  }
+}
+
+static TickType_t prvSample( const SimDistribution_t *pxDist )
+{
+  double dValue;
+
+  switch( pxDist->iKind )
+  {
+    case simDIST_UNIFORM:
+      dValue = std::uniform_real_distribution< double >( pxDist->dA, pxDist->dB )( xRandom );
+      break;
+    case simDIST_EXPONENTIAL:
+      dValue = std::exponential_distribution< double >( 1.0 / pxDist->dA )( xRandom );
+      break;
+    default:
+      dValue = pxDist->dA;
+      break;
+  }
+
+  dValue += 0.5;
+  return ( dValue < 1.0 ) ? ( TickType_t ) 1 : ( TickType_t ) dValue;
+}
+
+static double prvNextGap( void )
+{
+  return std::exponential_distribution< double >( 1.0 / xArrivals.dMeanGap )( xRandom );
+}
+
+static void prvPeriodicJob( void *pvParameters )
+{
+  SimTask_t *pxTask = ( SimTask_t * ) pvParameters;
+
+  vPortSimulatorExecute( prvSample( &pxTask->xExecTime ) );
+}
+
+static void prvAperiodicJob( void *pvParameters )
+{
+  SimJob_t *pxJob = ( SimJob_t * ) pvParameters;
+
+  vPortSimulatorExecute( pxJob->xExecTime );
+  xResponseTimes.push_back( ( uint32_t ) ( ullTick - pxJob->ullArrival ) );
+  delete pxJob;
+}
+
+static uint32_t prvPercentile( std::vector< uint32_t > *pxSorted, unsigned uPercent )
+{
+  if( pxSorted->empty() )
+  {
+    return 0;
+  }
+  return ( *pxSorted )[ ( pxSorted->size() - 1 ) * uPercent / 100 ];
+}
+
+/* Sends the result line of the run to the parent and ends the child. */
+static void prvFinish( const char *pcStatus )
+{
+  std::string xLine;
+  char pcField[ 96 ];
+  uint64_t ullSum = 0;
+
+  std::sort( xResponseTimes.begin(), xResponseTimes.end() );
+  for( uint32_t ulResponse : xResponseTimes )
+  {
+    ullSum += ulResponse;
+  }
+
+  snprintf( pcField, sizeof( pcField ), "%lu,%lu,%s,%llu,%lu,%lu,%lu,%.2f",
+            ulSimulatorServerPeriod, ulSimulatorServerBudget, pcStatus, ( unsigned long long ) ullTick,
+            ulArrived, ( unsigned long ) xResponseTimes.size(), ulDropped,
+            xResponseTimes.empty() ? 0.0 : ( double ) ullSum / ( double ) xResponseTimes.size() );
+  xLine += pcField;
+  snprintf( pcField, sizeof( pcField ), ",%lu,%lu,%lu,%lu",
+            ( unsigned long ) prvPercentile( &xResponseTimes, 50 ), ( unsigned long ) prvPercentile( &xResponseTimes, 95 ),
+            ( unsigned long ) prvPercentile( &xResponseTimes, 99 ), ( unsigned long ) prvPercentile( &xResponseTimes, 100 ) );
+  xLine += pcField;
+
+  #if( schedUSE_OVERLOAD_POLICIES == 1 )
+    for( SimTask_t &xTask : xTasks )
+    {
+      SchedOverloadStats_t xStats = { 0, 0, 0, 0, 0, 0, 0 };
+
+      if( 0 == strcmp( pcStatus, "ok" ) )
+      {
+        vSchedulerGetOverloadStats( xTask.xHandle, &xStats );
+      }
+      snprintf( pcField, sizeof( pcField ), ",%lu,%lu,%lu,%lu,%lu,%lu,%lu", xStats.ulCompleted, xStats.ulMissed, xStats.ulOverruns,
+                xStats.ulAborted, xStats.ulLate, xStats.ulSkipped, xStats.ulFirmViolations );
+      xLine += pcField;
+    }
+  #endif /* schedUSE_OVERLOAD_POLICIES */
+  #if( schedUSE_OVERHEAD_STATS == 1 )
+    for( UBaseType_t uxPart = 0; uxPart < schedOVERHEAD_PARTS; uxPart++ )
+    {
+      SchedOverheadStats_t xStats;
+
+      vSchedulerGetOverheadStats( uxPart, &xStats );
+      snprintf( pcField, sizeof( pcField ), ",%.1f,%lu,%lu",
+                ( 0 == xStats.ulCalls ) ? 0.0 : ( double ) xStats.ulTotal / ( double ) xStats.ulCalls, xStats.ulMax, xStats.ulCalls );
+      xLine += pcField;
+    }
+  #endif /* schedUSE_OVERHEAD_STATS */
+  xLine += "\n";
+
+  fflush( stdout );
+  if( ( ssize_t ) xLine.size() != write( iResultFd, xLine.c_str(), xLine.size() ) )
+  {
+    _exit( 1 );
+  }
+  _exit( 0 );
+}
+
+/* Queues an aperiodic job that arrives now. A job with a deadline also
+ * declares its execution time. Returns pdTRUE if the server was woken. */
+static BaseType_t prvInjectJob( TickType_t xExecTime, TickType_t xDeadline )
+{
+  SimJob_t *pxJob = new SimJob_t;
+  BaseType_t xWoken = pdFALSE;
+  BaseType_t xQueued;
+
+  pxJob->ullArrival = ullTick;
+  pxJob->xExecTime = xExecTime;
+  ulArrived++;
+  if( 0 == xDeadline )
+  {
+    xQueued = xCreateAperiodicJobFromISR( prvAperiodicJob, "ap", pxJob, NULL, &xWoken );
+  }
+  else
+  {
+    xQueued = xCreateAperiodicJobWithDeadlineFromISR( prvAperiodicJob, "ap", pxJob, NULL, xDeadline, xExecTime, &xWoken );
+  }
+  if( pdFALSE == xQueued )
+  {
+    ulDropped++;
+    delete pxJob;
+  }
+  return xWoken;
+}
+
+/* External events of the run, injected at every tick. */
+extern "C" BaseType_t xPortSimulatorTickHook( void )
+{
+  BaseType_t xSwitchRequired = pdFALSE;
+
+  ullTick++;
+  while( simARRIVALS_NONE != xArrivals.iKind && dNextArrival <= ( double ) ullTick )
+  {
+    for( unsigned long ulJob = 0; ulJob < xArrivals.ulBurstSize; ulJob++ )
+    {
+      if( pdFALSE != prvInjectJob( prvSample( &xAperiodicExecTime ), 0 ) )
+      {
+        xSwitchRequired = pdTRUE;
+      }
+    }
+    dNextArrival += prvNextGap();
+  }
+  while( uxNextExplicitJob < xExplicitJobs.size() && xExplicitJobs[ uxNextExplicitJob ].ullArrival <= ullTick )
+  {
+    if( pdFALSE != prvInjectJob( xExplicitJobs[ uxNextExplicitJob ].xExecTime, xExplicitJobs[ uxNextExplicitJob ].xDeadline ) )
+    {
+      xSwitchRequired = pdTRUE;
+    }
+    uxNextExplicitJob++;
+  }
+
+  if( ullTick >= ullDuration )
+  {
+    prvFinish( "ok" );
+  }
+  return xSwitchRequired;
+}
+
+/* Called by the idle hook, the processor is idle for one tick. */
+void loop( void )
+{
+  #if( schedUSE_EVENT_LOG == 1 )
+    if( xVerbose )
+    {
+      vSchedulerLogFlush();
+    }
+  #endif /* schedUSE_EVENT_LOG */
+  #if( POLLING_SERVER_BACKGROUND_SERVICE == 1 )
+    vSchedulerBackgroundServe();
+  #endif /* POLLING_SERVER_BACKGROUND_SERVICE */
+  vPortSimulatorExecute( 1 );
+}
+
+static void prvRun( void )
+{
+  xRandom.seed( ulSeed );
+  if( simARRIVALS_NONE != xArrivals.iKind )
+  {
+    dNextArrival = prvNextGap();
+  }
+
+  vSchedulerInit();
+  for( SimTask_t &xTask : xTasks )
+  {
+    vSchedulerPeriodicTaskCreate( prvPeriodicJob, xTask.pcName, configMINIMAL_STACK_SIZE, &xTask, 1, &xTask.xHandle,
+                                  0, xTask.xPeriod, xTask.xMaxExecTime, xTask.xDeadline );
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      vSchedulerPeriodicTaskSetOverloadPolicy( &xTask.xHandle, xTask.uxPolicy, xTask.uxM, xTask.uxK );
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+  }
+
+  /* Only returns if the admission control rejects the set. */
+  vSchedulerStart();
+  prvFinish( "rejected" );
+}
+
+/* Forks the child that simulates one combination, its result line is read
+ * from the returned pipe. */
+static int prvStartRun( unsigned long ulPeriod, unsigned long ulBudget, pid_t *pxPid )
+{
+  int piPipe[ 2 ];
+
+  if( 0 != pipe( piPipe ) )
+  {
+    perror( "pipe" );
+    exit( 1 );
+  }
+  fflush( stdout );
+
+  *pxPid = fork();
+  if( *pxPid < 0 )
+  {
+    perror( "fork" );
+    exit( 1 );
+  }
+  if( 0 == *pxPid )
+  {
+    close( piPipe[ 0 ] );
+    iResultFd = piPipe[ 1 ];
+    ulSimulatorServerPeriod = ulPeriod;
+    ulSimulatorServerBudget = ulBudget;
+    if( !xVerbose && NULL == freopen( "/dev/null", "w", stdout ) )
+    {
+      _exit( 1 );
+    }
+    prvRun();
+  }
+
+  close( piPipe[ 1 ] );
+  return piPipe[ 0 ];
+}
+
+static void prvPrintRun( int iFd, pid_t xPid, unsigned long ulPeriod, unsigned long ulBudget )
+{
+  std::string xLine;
+  char pcBuffer[ 256 ];
+  ssize_t xRead;
+  int iStatus;
+
+  while( ( xRead = read( iFd, pcBuffer, sizeof( pcBuffer ) ) ) > 0 )
+  {
+    xLine.append( pcBuffer, ( size_t ) xRead );
+  }
+  close( iFd );
+  waitpid( xPid, &iStatus, 0 );
+
+  if( xLine.empty() )
+  {
+    fprintf( stderr, "run with server period %lu and budget %lu failed\n", ulPeriod, ulBudget );
+    return;
+  }
+  fputs( xLine.c_str(), stdout );
+  fflush( stdout );
+}
+
+int main( int argc, char **argv )
+{
+  std::vector< unsigned long > xPeriods( 1, 200 );
+  std::vector< unsigned long > xBudgets( 1, 100 );
+  unsigned long ulJobs = 1;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    const char *pcArg = ( i + 1 < argc ) ? argv[ i + 1 ] : NULL;
+    bool xValid = ( NULL != pcArg );
+
+    if( 0 == strcmp( argv[ i ], "-v" ) )
+    {
+      xVerbose = true;
+      continue;
+    }
+    if( 0 == strcmp( argv[ i ], "-L" ) )
+    {
+      printf( "%d\n", prvMaxPeriodicTasks() );
+      return 0;
+    }
+    if( 0 == strcmp( argv[ i ], "-t" ) && xValid )
+    {
+      SimTask_t xTask;
+
+      xValid = prvParseTask( pcArg, &xTask );
+      xTask.uxPolicy = 0;   /* schedOVERLOAD_RECREATE */
+      xTask.uxM = 1;
+      xTask.uxK = 1;
+      xTask.xHandle = NULL;
+      snprintf( xTask.pcName, sizeof( xTask.pcName ), "t%u", ( unsigned ) xTasks.size() + 1 );
+      xTasks.push_back( xTask );
+    }
+    #if( schedUSE_OVERLOAD_POLICIES == 1 )
+      else if( 0 == strcmp( argv[ i ], "-o" ) && xValid && !xTasks.empty() )
+      {
+        xValid = prvParsePolicy( pcArg, &xTasks.back() );
+      }
+    #endif /* schedUSE_OVERLOAD_POLICIES */
+    else if( 0 == strcmp( argv[ i ], "-a" ) && xValid )
+    {
+      xValid = prvParseArrivals( pcArg );
+    }
+    else if( 0 == strcmp( argv[ i ], "-e" ) && xValid )
+    {
+      xValid = prvParseDistribution( pcArg, &xAperiodicExecTime );
+    }
+    else if( 0 == strcmp( argv[ i ], "-A" ) && xValid )
+    {
+      SimExplicitJob_t xJob;
+
+      xValid = prvParseExplicitJob( pcArg, &xJob );
+      xExplicitJobs.push_back( xJob );
+    }
+    else if( 0 == strcmp( argv[ i ], "-P" ) && xValid )
+    {
+      xValid = prvParseList( pcArg, &xPeriods );
+    }
+    else if( 0 == strcmp( argv[ i ], "-B" ) && xValid )
+    {
+      xValid = prvParseList( pcArg, &xBudgets );
+    }
+    else if( 0 == strcmp( argv[ i ], "-d" ) && xValid )
+    {
+      ullDuration = strtoull( pcArg, NULL, 10 );
+      xValid = ( 0 != ullDuration );
+    }
+    else if( 0 == strcmp( argv[ i ], "-s" ) && xValid )
+    {
+      ulSeed = strtoul( pcArg, NULL, 10 );
+    }
+    else if( 0 == strcmp( argv[ i ], "-j" ) && xValid )
+    {
+      ulJobs = strtoul( pcArg, NULL, 10 );
+      xValid = ( 0 != ulJobs );
+    }
+    else
+    {
+      xValid = false;
+    }
+
+    if( !xValid )
+    {
+      prvUsage();
+    }
+    i++;
+  }
+
+  std::stable_sort( xExplicitJobs.begin(), xExplicitJobs.end(),
+                    []( const SimExplicitJob_t &xA, const SimExplicitJob_t &xB ) { return xA.ullArrival < xB.ullArrival; } );
+
+  if( ( int ) xTasks.size() > prvMaxPeriodicTasks() )
+  {
+    fprintf( stderr, "at most %d periodic tasks, see -L\n", prvMaxPeriodicTasks() );
+    return 1;
+  }
+
+  printf( "server_period,server_budget,status,ticks,aperiodic_arrived,aperiodic_served,aperiodic_dropped,"
+          "response_mean,response_p50,response_p95,response_p99,response_max" );
+  #if( schedUSE_OVERLOAD_POLICIES == 1 )
+    for( SimTask_t &xTask : xTasks )
+    {
+      printf( ",%s_completed,%s_missed,%s_overruns,%s_aborted,%s_late,%s_skipped,%s_firm_violations",
+              xTask.pcName, xTask.pcName, xTask.pcName, xTask.pcName, xTask.pcName, xTask.pcName, xTask.pcName );
+    }
+  #endif /* schedUSE_OVERLOAD_POLICIES */
+  #if( schedUSE_OVERHEAD_STATS == 1 )
+    printf( ",tick_hook_mean,tick_hook_max,tick_hook_calls,scheduler_task_mean,scheduler_task_max,scheduler_task_calls,"
+            "priorities_mean,priorities_max,priorities_calls" );
+  #endif /* schedUSE_OVERHEAD_STATS */
+  printf( "\n" );
+
+  /* Runs are started ulJobs at a time, and printed in sweep order. */
+  std::vector< std::pair< unsigned long, unsigned long > > xSweep;
+  for( unsigned long ulPeriod : xPeriods )
+  {
+    for( unsigned long ulBudget : xBudgets )
+    {
+      xSweep.push_back( std::make_pair( ulPeriod, ulBudget ) );
+    }
+  }
+
+  for( size_t uxFirst = 0; uxFirst < xSweep.size(); uxFirst += ulJobs )
+  {
+    size_t uxEnd = std::min( xSweep.size(), uxFirst + ( size_t ) ulJobs );
+    std::vector< int > xFds;
+    std::vector< pid_t > xPids;
+
+    for( size_t uxRun = uxFirst; uxRun < uxEnd; uxRun++ )
+    {
+      pid_t xPid;
+      xFds.push_back( prvStartRun( xSweep[ uxRun ].first, xSweep[ uxRun ].second, &xPid ) );
+      xPids.push_back( xPid );
+    }
+    for( size_t uxRun = uxFirst; uxRun < uxEnd; uxRun++ )
+    {
+      prvPrintRun( xFds[ uxRun - uxFirst ], xPids[ uxRun - uxFirst ], xSweep[ uxRun ].first, xSweep[ uxRun ].second );
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,337 @@
+/* Offline analyzer for the binary scheduling trace of the scheduler (see
+ * src/schedTrace.h and schedUSE_TRACE in src/scheduler.h).
+ *
+ * Usage: traceAnalyzer <trace file> [-n name0,name1,...] [-g gantt.csv]
+ *
+ * Prints per task response-time histograms, start and response jitter,
+ * preemption counts and timing errors. With -g, the execution intervals seen
+ * through the schedTRACE_SWITCHED_IN events are exported as CSV lines
+ * "task,start,end" for plotting a Gantt chart. Names are given in the order
+ * of the tasks in the scheduler TCB array, which is their creation order. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "../src/schedTrace.h"
+
+/* Number of buckets of the response-time histograms. */
+#define traceHISTOGRAM_BUCKETS 10
+
+typedef struct traceTaskStats
+{
+  bool xSeen;
+  bool xJobActive;            /* Between schedTRACE_START and schedTRACE_FINISH. */
+  bool xSuspended;            /* Suspended by the scheduler task, not preempted. */
+  int64_t llReleaseTime;
+  std::vector< int64_t > xResponseTimes;
+  int64_t llMinStartDelay;
+  int64_t llMaxStartDelay;
+  unsigned long ulStarts;
+  unsigned long ulPreemptions;
+  unsigned long ulDeadlineMisses;
+  unsigned long ulBudgetExhausted;
+  unsigned long ulSuspensions;
+  unsigned long ulReplenishments;
+  int64_t llAperiodicStart;
+  std::vector< int64_t > xAperiodicTimes;
+} TraceTaskStats_t;
+
+static std::vector< std::string > xTaskNames;
+
+static std::string prvTaskName( unsigned uTask )
+{
+  if( schedTRACE_NO_TASK == uTask )
+  {
+    return "other";
+  }
+  if( uTask < xTaskNames.size() )
+  {
+    return xTaskNames[ uTask ];
+  }
+  return "task" + std::to_string( uTask );
+}
+
+static void prvSplitNames( const char *pcNames )
+{
+  std::string xNames( pcNames );
+  size_t xStart = 0, xEnd;
+
+  do
+  {
+    xEnd = xNames.find( ',', xStart );
+    xTaskNames.push_back( xNames.substr( xStart, ( std::string::npos == xEnd ) ? std::string::npos : xEnd - xStart ) );
+    xStart = xEnd + 1;
+  } while( std::string::npos != xEnd );
+}
+
+static void prvPrintHistogram( const std::vector< int64_t > &xValues )
+{
+  int64_t llMin = xValues[ 0 ], llMax = xValues[ 0 ], llSum = 0, llWidth;
+  unsigned long pulBuckets[ traceHISTOGRAM_BUCKETS ] = { 0 };
+
+  for( int64_t llValue : xValues )
+  {
+    llMin = ( llValue < llMin ) ? llValue : llMin;
+    llMax = ( llValue > llMax ) ? llValue : llMax;
+    llSum += llValue;
+  }
+  printf( "  response time: min %lld, avg %.1f, max %lld, jitter %lld ticks\n",
+          ( long long ) llMin, ( double ) llSum / xValues.size(), ( long long ) llMax, ( long long ) ( llMax - llMin ) );
+
+  llWidth = ( llMax - llMin ) / traceHISTOGRAM_BUCKETS + 1;
+  for( int64_t llValue : xValues )
+  {
+    pulBuckets[ ( llValue - llMin ) / llWidth ]++;
+  }
+  for( int i = 0; i < traceHISTOGRAM_BUCKETS; i++ )
+  {
+    if( 0 != pulBuckets[ i ] )
+    {
+      printf( "    [%6lld, %6lld) %6lu\n", ( long long ) ( llMin + i * llWidth ),
+              ( long long ) ( llMin + ( i + 1 ) * llWidth ), pulBuckets[ i ] );
+    }
+  }
+}
+
+int main( int argc, char **argv )
+{
+  const char *pcTracePath = NULL, *pcGanttPath = NULL;
+  FILE *pxTrace, *pxGantt = NULL;
+  SchedTraceRecord_t xRecord;
+  TraceTaskStats_t pxStats[ 256 ];
+  int64_t llTick = 0, llRunningSince = 0;
+  unsigned uRunning = schedTRACE_NO_TASK;
+  bool xFirst = true, xRunningKnown = false;
+  unsigned long ulRecords = 0, ulLost = 0;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( 0 == strcmp( argv[ i ], "-n" ) && i + 1 < argc )
+    {
+      prvSplitNames( argv[ ++i ] );
+    }
+    else if( 0 == strcmp( argv[ i ], "-g" ) && i + 1 < argc )
+    {
+      pcGanttPath = argv[ ++i ];
+    }
+    else
+    {
+      pcTracePath = argv[ i ];
+    }
+  }
+  if( NULL == pcTracePath )
+  {
+    fprintf( stderr, "usage: %s <trace file> [-n name0,name1,...] [-g gantt.csv]\n", argv[ 0 ] );
+    return 1;
+  }
+
+  pxTrace = fopen( pcTracePath, "rb" );
+  if( NULL == pxTrace )
+  {
+    perror( pcTracePath );
+    return 1;
+  }
+  if( NULL != pcGanttPath )
+  {
+    pxGantt = fopen( pcGanttPath, "w" );
+    if( NULL == pxGantt )
+    {
+      perror( pcGanttPath );
+      return 1;
+    }
+    fprintf( pxGantt, "task,start,end\n" );
+  }
+
+  for( int i = 0; i < 256; i++ )
+  {
+    pxStats[ i ].xSeen = false;
+    pxStats[ i ].xJobActive = false;
+    pxStats[ i ].xSuspended = false;
+    pxStats[ i ].llReleaseTime = 0;
+    pxStats[ i ].llMinStartDelay = INT64_MAX;
+    pxStats[ i ].llMaxStartDelay = 0;
+    pxStats[ i ].ulStarts = 0;
+    pxStats[ i ].ulPreemptions = 0;
+    pxStats[ i ].ulDeadlineMisses = 0;
+    pxStats[ i ].ulBudgetExhausted = 0;
+    pxStats[ i ].ulSuspensions = 0;
+    pxStats[ i ].ulReplenishments = 0;
+    pxStats[ i ].llAperiodicStart = 0;
+  }
+
+  while( 1 == fread( &xRecord, sizeof( xRecord ), 1, pxTrace ) )
+  {
+    TraceTaskStats_t *pxTask = &pxStats[ xRecord.ucTask ];
+    int64_t llTime;
+
+    /* Only the low 16 bits of the tick are stored. Records are close in time,
+     * so the tick is the one nearest to the previous record. Release records
+     * carry the release time, which may be earlier than the previous record. */
+    if( xFirst )
+    {
+      llTick = xRecord.usTick;
+      xFirst = false;
+    }
+    else
+    {
+      llTick += ( int16_t ) ( uint16_t ) ( xRecord.usTick - ( uint16_t ) llTick );
+    }
+    llTime = llTick;
+    ulRecords++;
+
+    if( schedTRACE_NO_TASK != xRecord.ucTask && schedTRACE_OVERFLOW != xRecord.ucEvent )
+    {
+      pxTask->xSeen = true;
+    }
+
+    switch( xRecord.ucEvent )
+    {
+      case schedTRACE_RELEASE:
+        pxTask->llReleaseTime = llTime;
+        break;
+
+      case schedTRACE_START:
+        pxTask->xJobActive = true;
+        pxTask->ulStarts++;
+        if( llTime - pxTask->llReleaseTime < pxTask->llMinStartDelay )
+        {
+          pxTask->llMinStartDelay = llTime - pxTask->llReleaseTime;
+        }
+        if( llTime - pxTask->llReleaseTime > pxTask->llMaxStartDelay )
+        {
+          pxTask->llMaxStartDelay = llTime - pxTask->llReleaseTime;
+        }
+        break;
+
+      case schedTRACE_FINISH:
+        if( pxTask->xJobActive )
+        {
+          pxTask->xResponseTimes.push_back( llTime - pxTask->llReleaseTime );
+        }
+        pxTask->xJobActive = false;
+        break;
+
+      case schedTRACE_SWITCHED_IN:
+        if( xRunningKnown && uRunning != xRecord.ucTask )
+        {
+          /* A task switched out in the middle of a job was preempted, unless
+           * it was suspended for exceeding its execution time. */
+          if( pxStats[ uRunning ].xJobActive && !pxStats[ uRunning ].xSuspended )
+          {
+            pxStats[ uRunning ].ulPreemptions++;
+          }
+          if( NULL != pxGantt )
+          {
+            fprintf( pxGantt, "%s,%lld,%lld\n", prvTaskName( uRunning ).c_str(), ( long long ) llRunningSince, ( long long ) llTime );
+          }
+        }
+        if( !xRunningKnown || uRunning != xRecord.ucTask )
+        {
+          llRunningSince = llTime;
+        }
+        uRunning = xRecord.ucTask;
+        xRunningKnown = true;
+        break;
+
+      case schedTRACE_APERIODIC_START:
+        pxTask->llAperiodicStart = llTime;
+        break;
+
+      case schedTRACE_APERIODIC_FINISH:
+        pxTask->xAperiodicTimes.push_back( llTime - pxTask->llAperiodicStart );
+        break;
+
+      case schedTRACE_DEADLINE_MISSED:
+        pxTask->ulDeadlineMisses++;
+        /* The task is recreated, the job is abandoned. */
+        pxTask->xJobActive = false;
+        break;
+
+      case schedTRACE_BUDGET_EXHAUSTED:
+        pxTask->ulBudgetExhausted++;
+        break;
+
+      case schedTRACE_SUSPEND:
+        pxTask->ulSuspensions++;
+        pxTask->xSuspended = true;
+        break;
+
+      case schedTRACE_RESUME:
+        pxTask->xSuspended = false;
+        break;
+
+      case schedTRACE_REPLENISH:
+        pxTask->ulReplenishments++;
+        break;
+
+      case schedTRACE_OVERFLOW:
+        ulLost += xRecord.ucTask;
+        break;
+
+      default:
+        fprintf( stderr, "unknown event %u at record %lu\n", xRecord.ucEvent, ulRecords );
+        break;
+    }
+  }
+  fclose( pxTrace );
+
+  if( NULL != pxGantt )
+  {
+    if( xRunningKnown )
+    {
+      fprintf( pxGantt, "%s,%lld,%lld\n", prvTaskName( uRunning ).c_str(), ( long long ) llRunningSince, ( long long ) llTick );
+    }
+    fclose( pxGantt );
+  }
+
+  printf( "%lu records, %lld ticks", ulRecords, ( long long ) ( xFirst ? 0 : llTick ) );
+  if( 0 != ulLost )
+  {
+    printf( ", at least %lu records lost, results are incomplete", ulLost );
+  }
+  printf( "\n" );
+
+  for( int i = 0; i < schedTRACE_NO_TASK; i++ )
+  {
+    TraceTaskStats_t *pxTask = &pxStats[ i ];
+
+    if( !pxTask->xSeen )
+    {
+      continue;
+    }
+    printf( "\n%s: %lu jobs, %lu preemptions, %lu deadline misses, %lu budget overruns, %lu suspensions\n",
+            prvTaskName( i ).c_str(), ( unsigned long ) pxTask->xResponseTimes.size(), pxTask->ulPreemptions,
+            pxTask->ulDeadlineMisses, pxTask->ulBudgetExhausted, pxTask->ulSuspensions );
+    if( 0 != pxTask->ulStarts )
+    {
+      printf( "  start delay: min %lld, max %lld, jitter %lld ticks\n", ( long long ) pxTask->llMinStartDelay,
+              ( long long ) pxTask->llMaxStartDelay, ( long long ) ( pxTask->llMaxStartDelay - pxTask->llMinStartDelay ) );
+    }
+    if( !pxTask->xResponseTimes.empty() )
+    {
+      prvPrintHistogram( pxTask->xResponseTimes );
+    }
+    if( !pxTask->xAperiodicTimes.empty() )
+    {
+      int64_t llMax = 0, llSum = 0;
+      for( int64_t llValue : pxTask->xAperiodicTimes )
+      {
+        llMax = ( llValue > llMax ) ? llValue : llMax;
+        llSum += llValue;
+      }
+      printf( "  aperiodic jobs: %lu, execution avg %.1f, max %lld ticks\n", ( unsigned long ) pxTask->xAperiodicTimes.size(),
+              ( double ) llSum / pxTask->xAperiodicTimes.size(), ( long long ) llMax );
+    }
+    if( 0 != pxTask->ulReplenishments )
+    {
+      printf( "  budget replenishments: %lu\n", pxTask->ulReplenishments );
+    }
+  }
+
+  return 0;
+}